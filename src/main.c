@@ -1,8 +1,10 @@
 #include <assert.h>
 #include <fcntl.h>
 #include <math.h>
+#include <pthread.h>
 #include <stdint.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include <sys/mman.h>
 #include <sys/stat.h>
@@ -15,9 +17,14 @@
 
 #include <GLFW/glfw3.h>
 
+#include "ring.h"
+
+typedef uint8_t  u8;
+typedef uint16_t u16;
 typedef uint32_t u32;
 typedef uint64_t u64;
 typedef int32_t  i32;
+typedef int64_t  i64;
 typedef float    f32;
 typedef double   f64;
 
@@ -25,6 +32,8 @@ STATIC_ASSERT(sizeof(f32) == sizeof(u32));
 STATIC_ASSERT(sizeof(f64) == sizeof(u64));
 STATIC_ASSERT(sizeof(void*) == sizeof(u64));
 
+STATIC_ASSERT(sizeof(RingPoint) == sizeof(f32) * 2);
+
 typedef struct stat FileStat;
 
 typedef struct timespec Time;
@@ -70,6 +79,81 @@ typedef struct {
     Vec2f points[4];
 } Quad;
 
+typedef struct {
+    u32 from;
+    u32 to;
+    u32 id;
+} Edge;
+
+// NOTE: Indexed store of the occluder edges a single viewer needs to test its rays against; see
+// `occluders_push`.
+typedef struct {
+    Vec2f* vertices;
+    Edge*  edges;
+    u32*   table;
+    u32    len_vertices;
+    u32    len_edges;
+    u32    cap_vertices;
+    u32    cap_edges;
+    u32    cap_table;
+} Occluders;
+
+typedef struct {
+    Vec2f            origin;
+    const Occluders* occluders;
+    const Geom*      border;
+    Vec2f*           points;
+    u32              len_points;
+} Rays;
+
+typedef void (*Job)(void* argument, u32 index, u32 len_threads);
+
+typedef struct {
+    pthread_barrier_t start;
+    pthread_barrier_t stop;
+    Job               job;
+    void*             argument;
+    u32               len_threads;
+    Bool              quit;
+    u64               pairs_min;
+} Pool;
+
+typedef struct {
+    Pool*     pool;
+    pthread_t thread;
+    u32       index;
+} Worker;
+
+typedef struct {
+    Vec2f origin;
+    Vec2f direction;
+    f32   distance;
+} Ray;
+
+typedef struct {
+    Vec2f normal;
+    f32   distance;
+    u32   id;
+} Hit;
+
+// NOTE: Whatever the GLFW callbacks need to hand over to the frame loop; `width` and `height` are
+// the framebuffer's size in pixels.
+typedef struct {
+    Bool shadow_map;
+    Bool low_latency;
+    u32  pins;
+    i32  width;
+    i32  height;
+} Events;
+
+typedef struct {
+    u8* buffer;
+    u64 cap;
+    u64 len;
+    u64 high_water;
+    u64 overflows;
+} Arena;
+
 #define NANOS_PER_SECOND 1000000000
 
 #define PI  ((f32)M_PI)
@@ -77,6 +161,8 @@ typedef struct {
 
 #define EPSILON 0.00001f
 
+// NOTE: The window opens at this size but can be resized at will; chunks stay sized off of it
+// either way, and the diagonal stays the range of sight.
 #if 0
     #define WINDOW_WIDTH    2500
     #define WINDOW_HEIGHT   1150
@@ -95,15 +181,43 @@ typedef struct {
 #define VIEW_FAR  1.0f
 
 #if 1
-    #define VIEW_TRANSLATE      ((Vec2f){WINDOW_WIDTH, WINDOW_HEIGHT})
     #define VIEW_ROTATE_RADIANS ((180.0f * PI) / 180.0f)
 #else
-    #define VIEW_TRANSLATE      ((Vec2f){0})
     #define VIEW_ROTATE_RADIANS 0
 #endif
 
+#define CHUNK_WIDTH  (WINDOW_WIDTH / 2)
+#define CHUNK_HEIGHT (WINDOW_HEIGHT / 2)
+
+#define CHUNK_COLS 32
+#define CHUNK_ROWS 32
+
+#define WORLD_WIDTH  (CHUNK_WIDTH * CHUNK_COLS)
+#define WORLD_HEIGHT (CHUNK_HEIGHT * CHUNK_ROWS)
+
+// NOTE: The view never covers more of the world than `VIEW_MAX_WIDTH` by `VIEW_MAX_HEIGHT`; larger
+// framebuffers zoom in until it does (see `view_extent`). Everything sized by how much of the
+// world can be in view at once is sized for that: the view touches at most `VIEW_MAX_COLS` by
+// `VIEW_MAX_ROWS` chunks, and chunks stay resident up to `CHUNK_RADIUS_RESIDENT_MAX` away from
+// the camera's chunk (see `chunks_radius`).
+#define VIEW_MAX_WIDTH  3840
+#define VIEW_MAX_HEIGHT 2160
+
+#define VIEW_MAX_COLS (((VIEW_MAX_WIDTH + CHUNK_WIDTH - 1) / CHUNK_WIDTH) + 1)
+#define VIEW_MAX_ROWS (((VIEW_MAX_HEIGHT + CHUNK_HEIGHT - 1) / CHUNK_HEIGHT) + 1)
+
+#define CHUNK_RADIUS_COLS_MAX (((VIEW_MAX_WIDTH / 2) + CHUNK_WIDTH - 1) / CHUNK_WIDTH)
+#define CHUNK_RADIUS_ROWS_MAX (((VIEW_MAX_HEIGHT / 2) + CHUNK_HEIGHT - 1) / CHUNK_HEIGHT)
+#define CHUNK_RADIUS_RESIDENT_MAX                                               \
+    (1 + (CHUNK_RADIUS_COLS_MAX < CHUNK_RADIUS_ROWS_MAX ? CHUNK_RADIUS_ROWS_MAX \
+                                                        : CHUNK_RADIUS_COLS_MAX))
+
+#define CAMERA_FOLLOW 0.1f
+
 #define LINE_WIDTH 1.825f
 
+#define FOV_RADIANS ((70.0f * PI) / 180.0f)
+
 #define COLOR_BACKGROUND ((Vec4f){0})
 
 #if 0
@@ -117,21 +231,248 @@ typedef struct {
 #endif
 
 #define COLOR_OBJECT ((Vec4f){0.25f, 0.25f, 0.25f, 1.0f})
+#define COLOR_MARKER ((Vec4f){1.0f, 0.375f, 0.3f, 1.0f})
 #define COLOR_WORLD  ((Vec4f){0.0f, 1.0f, 1.0f, 1.0f})
 
 #define COLOR_LINE_0 ((Vec4f){0.625f, 0.625f, 0.625f, 0.9f})
 #define COLOR_LINE_1 ((Vec4f){0.5f, 0.5f, 0.5f, 0.275f})
 
-#define CAP_LINES     (1 << 6)
-#define CAP_QUADS     (1 << 4)
-#define CAP_TRIANGLES (1 << 7)
-#define CAP_POINTS    (1 << 7)
+#define CAP_QUADS (1 << 8)
+
+// NOTE: Backs every per-frame working set (rotated quads, lines, ray points, triangles, queries);
+// see the `arena_high_water` stat for how much of it a given scene actually needs. Setting
+// `ENV_ARENA` to a number of bytes overrides the default, which is enough for a view of
+// `VIEW_MAX_WIDTH` by `VIEW_MAX_HEIGHT`.
+#define CAP_ARENA  (1 << 19)
+#define ENV_ARENA  "LOS_ARENA"
+#define CACHE_LINE 64
+
+STATIC_ASSERT((CACHE_LINE & (CACHE_LINE - 1)) == 0);
+
+#define CAP_QUERIES_BLOCK (1 << 6)
+
+// NOTE: The heatmap can keep every core busy, but a single viewer's rays rarely amount to more
+// than a few thousand ray-edge tests a frame, so the render pool is kept small; see
+// `pool_calibrate` for when it gets used at all.
+#define CAP_THREADS        (1 << 6)
+#define CAP_THREADS_RENDER (1 << 2)
+
+// NOTE: Setting `ENV_PAIRS_MIN` to a number of ray-edge tests overrides the measured break-even,
+// for when calibration guesses wrong on a given machine.
+#define POOL_CALIBRATE_RUNS  (1 << 6)
+#define POOL_CALIBRATE_EDGES (1 << 6)
+#define POOL_CALIBRATE_RAYS  (1 << 8)
+#define ENV_PAIRS_MIN        "LOS_PAIRS_MIN"
+
+// NOTE: Occluders that are not geoms of a chunk; see `geom_id` for those that are.
+#define ID_NONE   UINT32_MAX
+#define ID_PLAYER (UINT32_MAX - 1)
+#define ID_WORLD  (UINT32_MAX - 2)
+
+#define CAP_RAYS_BLOCK (1 << 6)
+
+#define CAP_BENCH_RAYS  (1 << 14)
+#define CAP_BENCH_ARENA (1 << 20)
+
+// NOTE: Every chunk polygon gets checked from this many viewers spread around it.
+#define BENCH_POLYGON_VIEWERS 16
+
+// NOTE: The heatmap covers `HEATMAP_COLS` by `HEATMAP_ROWS` chunks around the world's center, one
+// viewer every `HEATMAP_STEP` pixels, each of which sees as far as `HEATMAP_RADIUS`. Chunks within
+// that radius of the covered area are loaded as well, so viewers near its edges see all there is.
+#define HEATMAP_COLS        3
+#define HEATMAP_ROWS        3
+#define HEATMAP_STEP        8
+#define HEATMAP_RADIUS      (WINDOW_DIAGONAL / 2.0f)
+#define HEATMAP_MARGIN_COLS ((u32)ceilf(HEATMAP_RADIUS / CHUNK_WIDTH))
+#define HEATMAP_MARGIN_ROWS ((u32)ceilf(HEATMAP_RADIUS / CHUNK_HEIGHT))
+#define CAP_HEATMAP_CHUNKS  (1 << 7)
+#define CAP_HEATMAP_ARENA   (1 << 20)
+
+// NOTE: The single-threaded pass used to measure scaling only covers every `HEATMAP_SAMPLE`th row.
+#define HEATMAP_SAMPLE 8
+
+#define PATH_HEATMAP_IMAGE "heatmap.ppm"
+#define PATH_HEATMAP_DATA  "heatmap.f32"
+
+// NOTE: Occluder corners closer than `1 / VERTEX_SNAP` pixels to one another are treated as one.
+#define VERTEX_SNAP        64.0f
+#define CAP_POLYGON_POINTS 32
+
+#define CAP_CHUNKS          (1 << 7)
+#define CAP_CHUNK_GEOMS     4
+#define CAP_CHUNK_POLYGONS  1
+#define CAP_CHUNK_OCCLUDERS (CAP_CHUNK_GEOMS + CAP_CHUNK_POLYGONS)
+
+// NOTE: Enough for every edge of every chunk, each with corners of its own, and the world's border.
+#define CAP_STORE \
+    ((CAP_CHUNKS * ((CAP_CHUNK_GEOMS * 4) + (CAP_CHUNK_POLYGONS * CAP_POLYGON_POINTS))) + 4)
+#define CAP_STORE_ARENA (1 << 18)
+
+// NOTE: Chunk polygons are stars with between `STAR_SPIKES_MIN` and `STAR_SPIKES_MAX` spikes.
+#define STAR_SPIKES_MIN 4
+#define STAR_SPIKES_MAX 7
+
+STATIC_ASSERT((STAR_SPIKES_MAX * 2) <= CAP_POLYGON_POINTS);
+STATIC_ASSERT(CAP_POLYGON_POINTS <= 32);
+
+STATIC_ASSERT((((CHUNK_RADIUS_RESIDENT_MAX * 2) + 1) * ((CHUNK_RADIUS_RESIDENT_MAX * 2) + 1)) <=
+              CAP_CHUNKS);
+// NOTE: The world, the player, and the line-of-fire marker, on top of every touched chunk's geoms.
+STATIC_ASSERT((3 + (VIEW_MAX_COLS * VIEW_MAX_ROWS * CAP_CHUNK_GEOMS)) <= CAP_QUADS);
+
+STATIC_ASSERT(CAP_QUADS <= CAP_RING_VISIBLE);
+
+// NOTE: Every chunk is split into `PVS_CELLS` cells, each of which stores the static geoms (within
+// `PVS_RADIUS` chunks) that might be seen from somewhere inside of it. An entry is packed into 16
+// bits: `[dy:3][dx:3][geom:2][edges:4]`, with `dx` and `dy` offset by `PVS_RADIUS`.
+#define PVS_CELL_COLS 4
+#define PVS_CELL_ROWS 2
+#define PVS_CELLS     (PVS_CELL_COLS * PVS_CELL_ROWS)
+#define PVS_RADIUS    2
+#define PVS_SPAN      ((PVS_RADIUS * 2) + 1)
+#define CAP_PVS       (PVS_SPAN * PVS_SPAN * CAP_CHUNK_GEOMS)
+
+STATIC_ASSERT(PVS_SPAN <= 8);
+STATIC_ASSERT(CAP_CHUNK_GEOMS <= 4);
+STATIC_ASSERT(CAP_PVS <= 0xFF);
+
+// NOTE: Closed, simple, and star-shaped around the mean of its points, so it can be drawn as a
+// triangle fan from there.
+typedef struct {
+    Vec2f points[CAP_POLYGON_POINTS];
+    u32   len_points;
+} Polygon;
 
-#define CAP_VAO          4
-#define CAP_VBO          4
-#define CAP_INSTANCE_VBO 2
-#define CAP_FBO          2
-#define CAP_TEXTURES     2
+typedef struct {
+    Geom    geoms[CAP_CHUNK_GEOMS];
+    Quad    quads[CAP_CHUNK_GEOMS];
+    Bool    spin[CAP_CHUNK_GEOMS];
+    Polygon polygons[CAP_CHUNK_POLYGONS];
+    u16     pvs[PVS_CELLS][CAP_PVS];
+    u8      len_pvs[PVS_CELLS];
+    u32     len_geoms;
+    u32     len_polygons;
+    u32     col;
+    u32     row;
+    Bool    loaded;
+    Bool    touched;
+} Chunk;
+
+// NOTE: Every occluder of every loaded chunk, plus the world's border, unculled. Queries from
+// arbitrary origins (`raycast`) go straight at it, and each viewer's culled `Occluders` get copied
+// out of it; `firsts` and `lens` say which of its edges belong to which chunk's geom or polygon.
+// Only the edges of spinning geoms are redone every frame; they sit past `len_edges` and
+// `len_vertices`, which is where the rest ends.
+typedef struct {
+    Arena     arena;
+    Occluders occluders;
+    u32       firsts[CAP_CHUNKS][CAP_CHUNK_OCCLUDERS];
+    u32       lens[CAP_CHUNKS][CAP_CHUNK_OCCLUDERS];
+    u32       len_vertices;
+    u32       len_edges;
+    u32       signature;
+    Bool      built;
+} Store;
+
+// NOTE: How many chunks can be on their way through the loader thread at once, counting those
+// queued up, the one being generated, and those finished but not yet picked up.
+#define CAP_LOADS (1 << 4)
+
+typedef struct {
+    u32 col;
+    u32 row;
+} Coord;
+
+// NOTE: Generating a chunk means generating all of its neighbors again and building its PVS, which
+// is too slow to do on the render thread. The frame loop queues up `requests`; the loader thread
+// works through them one at a time and leaves the results in `ready`. `pending` is owned by the
+// frame loop, and holds every chunk it has asked for but not yet gotten back.
+typedef struct {
+    Chunk           ready[CAP_LOADS];
+    Coord           requests[CAP_LOADS];
+    Coord           pending[CAP_LOADS];
+    pthread_t       thread;
+    pthread_mutex_t mutex;
+    pthread_cond_t  wake;
+    u32             len_ready;
+    u32             len_requests;
+    u32             len_pending;
+    Bool            quit;
+} Loader;
+
+#define CAP_VIEWERS 16
+
+// NOTE: Frames in flight whose input-to-present latency has yet to be measured, and how many
+// measurements are kept between stats printouts.
+#define CAP_FENCES    4
+#define CAP_LATENCIES (1 << 10)
+
+#define FENCE_TIMEOUT_NANOS (NANOS_PER_SECOND / 10)
+
+typedef struct {
+    GLsync sync;
+    u64    sampled;
+} Fence;
+
+// NOTE: Tracks frames from the moment their input was sampled until the GPU got through the swap
+// that presented them.
+typedef struct {
+    Fence fences[CAP_FENCES];
+    u64   latencies[CAP_LATENCIES];
+    u32   first;
+    u32   len_fences;
+    u32   len_latencies;
+} Present;
+
+// NOTE: GPU timer queries in flight, and how many frames the quality governor averages over before
+// it considers changing the render scale or sample count. It lowers quality once the GPU takes more
+// than `GOVERNOR_DEGRADE` of the frame budget, and only raises it again once neither the GPU nor
+// the CPU take more than `GOVERNOR_RESTORE`, so that a step up does not immediately undo itself.
+#define CAP_TIMERS       4
+#define CAP_QUALITIES    10
+#define GOVERNOR_FRAMES  30
+#define GOVERNOR_DEGRADE 0.9f
+#define GOVERNOR_RESTORE 0.55f
+
+typedef struct {
+    f32 scale;
+    i32 samples;
+} Quality;
+
+// NOTE: `qualities` runs from best to cheapest and `level` indexes into it. `gpu_nanos` and
+// `cpu_nanos` hold the averages the last decision was made on. The next `len_discards` GPU timings
+// to come back are thrown out rather than averaged.
+typedef struct {
+    u32     timers[CAP_TIMERS];
+    Quality qualities[CAP_QUALITIES];
+    u64     gpu_sum;
+    u64     cpu_sum;
+    u64     gpu_nanos;
+    u64     cpu_nanos;
+    u32     first;
+    u32     len_timers;
+    u32     len_gpu;
+    u32     len_cpu;
+    u32     len_qualities;
+    u32     len_discards;
+    u32     level;
+    Bool    timing;
+} Governor;
+
+// NOTE: Angular resolution of the polar shadow map; each viewer gets one row of this many bins.
+#define POLAR_BINS     (1 << 11)
+#define POLAR_VERTICES 12
+
+#define CAP_VAO          7
+#define CAP_VBO          6
+#define CAP_INSTANCE_VBO 4
+#define CAP_FBO          3
+#define CAP_TEXTURES     3
+
+// NOTE: The cached static layer (the last target) extends this many render pixels past the window
+// on every side, which is how far the camera can drift before it has to be redrawn.
+#define LAYER_MARGIN 128
 
 #define PATH_GEOM_VERT "src/geom_vert.glsl"
 #define PATH_GEOM_FRAG "src/geom_frag.glsl"
@@ -142,6 +483,12 @@ typedef struct {
 #define PATH_SHADOW_VERT "src/shadow_vert.glsl"
 #define PATH_SHADOW_FRAG "src/shadow_frag.glsl"
 
+#define PATH_POLAR_VERT "src/polar_vert.glsl"
+#define PATH_POLAR_FRAG "src/polar_frag.glsl"
+
+#define PATH_MASK_VERT "src/mask_vert.glsl"
+#define PATH_MASK_FRAG "src/mask_frag.glsl"
+
 #define BIND_BUFFER(object, data, size, target, usage) \
     do {                                               \
         glBindBuffer(target, object);                  \
@@ -236,54 +583,1861 @@ static Vec2f extend(Vec2f a, Vec2f b, f32 length) {
     };
 }
 
-static Mat4 translate_rotate(Vec2f translate, f32 rotate_radians) {
-    const f32 s = sinf(rotate_radians);
-    const f32 c = cosf(rotate_radians);
-    return (Mat4){
-        .column_row[0][0] = c,
-        .column_row[0][1] = s,
-        .column_row[1][0] = -s,
-        .column_row[1][1] = c,
-        .column_row[2][2] = 1.0f,
-        .column_row[3][0] = translate.x,
-        .column_row[3][1] = translate.y,
-        .column_row[3][3] = 1.0f,
-    };
+static Mat4 translate_rotate(Vec2f translate, f32 rotate_radians) {
+    const f32 s = sinf(rotate_radians);
+    const f32 c = cosf(rotate_radians);
+    return (Mat4){
+        .column_row[0][0] = c,
+        .column_row[0][1] = s,
+        .column_row[1][0] = -s,
+        .column_row[1][1] = c,
+        .column_row[2][2] = 1.0f,
+        .column_row[3][0] = translate.x,
+        .column_row[3][1] = translate.y,
+        .column_row[3][3] = 1.0f,
+    };
+}
+
+static Mat4 orthographic(f32 left, f32 right, f32 bottom, f32 top, f32 near, f32 far) {
+    return (Mat4){
+        .column_row[0][0] = 2.0f / (right - left),
+        .column_row[1][1] = 2.0f / (top - bottom),
+        .column_row[2][2] = 2.0f / (near - far),
+        .column_row[3][3] = 1.0f,
+        .column_row[3][0] = (left + right) / (left - right),
+        .column_row[3][1] = (bottom + top) / (bottom - top),
+        .column_row[3][2] = (near + far) / (near - far),
+    };
+}
+
+static void intersect(const Vec2f a[2], const Vec2f b[2], Vec2f* point) {
+    const f32 x0 = a[0].x - a[1].x;
+    const f32 y0 = a[0].y - a[1].y;
+
+    const f32 x1 = a[0].x - b[0].x;
+    const f32 y1 = a[0].y - b[0].y;
+
+    const f32 x2 = b[0].x - b[1].x;
+    const f32 y2 = b[0].y - b[1].y;
+
+    const f32 denominator = (x0 * y2) - (y0 * x2);
+    if (denominator == 0.0f) {
+        return;
+    }
+    const f32 t = ((x1 * y2) - (y1 * x2)) / denominator;
+    const f32 u = -((x0 * y1) - (y0 * x1)) / denominator;
+    if ((t < 0.0f) || (1.0f < t) || (u < 0.0f) || (1.0f < u)) {
+        return;
+    }
+    point->x = a[0].x + (t * (a[1].x - a[0].x));
+    point->y = a[0].y + (t * (a[1].y - a[0].y));
+}
+
+static f32 cross(Vec2f origin, Vec2f a, Vec2f b) {
+    return ((a.x - origin.x) * (b.y - origin.y)) - ((a.y - origin.y) * (b.x - origin.x));
+}
+
+static u32 hash(u32 x) {
+    x ^= x >> 16;
+    x *= 0x7FEB352D;
+    x ^= x >> 15;
+    x *= 0x846CA68B;
+    x ^= x >> 16;
+    return x;
+}
+
+static f32 random_f32(u32* state) {
+    *state = hash(*state);
+    return ((f32)(*state >> 8)) / ((f32)(1 << 24));
+}
+
+static f32 clamp(f32 x, f32 min, f32 max) {
+    return x < min ? min : max < x ? max : x;
+}
+
+// NOTE: How much of the world a `width` by `height` framebuffer shows: one unit per pixel, unless
+// that would be more than `VIEW_MAX_WIDTH` by `VIEW_MAX_HEIGHT`, in which case it zooms in evenly
+// until it is not.
+static Vec2f view_extent(i32 width, i32 height) {
+    const f32 zoom =
+        fmaxf(1.0f, fmaxf((f32)width / VIEW_MAX_WIDTH, (f32)height / VIEW_MAX_HEIGHT));
+    return (Vec2f){(f32)width / zoom, (f32)height / zoom};
+}
+
+static Vec2f camera_translate(Vec2f camera, Vec2f screen) {
+    const Vec2f rotated = turn((Vec2f){0}, camera, -VIEW_ROTATE_RADIANS);
+    return (Vec2f){
+        (screen.x / 2.0f) - rotated.x,
+        (screen.y / 2.0f) - rotated.y,
+    };
+}
+
+static void chunk_generate(Chunk* chunk, u32 col, u32 row) {
+    u32 state = hash((row * CHUNK_COLS) + col + 1);
+
+    chunk->col = col;
+    chunk->row = row;
+    chunk->loaded = TRUE;
+    chunk->touched = FALSE;
+    chunk->len_geoms = 1 + (hash(state) % CAP_CHUNK_GEOMS);
+    for (u32 i = 0; i < chunk->len_geoms; ++i) {
+        Vec2f scale = {
+            5.0f + (random_f32(&state) * 20.0f),
+            25.0f + (random_f32(&state) * 125.0f),
+        };
+        if (random_f32(&state) < 0.5f) {
+            scale = (Vec2f){scale.y, scale.x};
+        }
+
+        // NOTE: Keep the whole footprint of the geom inside its chunk at any rotation, so a chunk
+        // only ever needs to be touched when its own bounds are in view.
+        const f32   radius = sqrtf((scale.x * scale.x) + (scale.y * scale.y)) / 2.0f;
+        const Vec2f center = {
+            ((f32)(col * CHUNK_WIDTH)) + radius +
+                (random_f32(&state) * (CHUNK_WIDTH - (radius * 2.0f))),
+            ((f32)(row * CHUNK_HEIGHT)) + radius +
+                (random_f32(&state) * (CHUNK_HEIGHT - (radius * 2.0f))),
+        };
+
+        chunk->geoms[i] = (Geom){
+            {center.x - (scale.x / 2.0f), center.y - (scale.y / 2.0f)},
+            scale,
+            COLOR_OBJECT,
+            random_f32(&state) * TAU,
+        };
+        chunk->quads[i] = geom_to_quad(chunk->geoms[i]);
+        chunk->spin[i] = random_f32(&state) < 0.5f ? TRUE : FALSE;
+    }
+
+    // NOTE: About every other chunk also gets a star, which never moves. Its points alternate
+    // between the outer and inner radius at even angles, so their mean is its center.
+    chunk->len_polygons = 0;
+    if (random_f32(&state) < 0.5f) {
+        Polygon*  polygon = &chunk->polygons[chunk->len_polygons++];
+        const u32 len_spikes =
+            STAR_SPIKES_MIN + (hash(state) % ((STAR_SPIKES_MAX - STAR_SPIKES_MIN) + 1));
+        const f32   outer = 20.0f + (random_f32(&state) * 40.0f);
+        const f32   inner = outer * (0.35f + (random_f32(&state) * 0.25f));
+        const Vec2f center = {
+            ((f32)(col * CHUNK_WIDTH)) + outer +
+                (random_f32(&state) * (CHUNK_WIDTH - (outer * 2.0f))),
+            ((f32)(row * CHUNK_HEIGHT)) + outer +
+                (random_f32(&state) * (CHUNK_HEIGHT - (outer * 2.0f))),
+        };
+        const f32 rotate_radians = random_f32(&state) * TAU;
+
+        polygon->len_points = len_spikes * 2;
+        for (u32 i = 0; i < polygon->len_points; ++i) {
+            const f32 radius = (i % 2) == 0 ? outer : inner;
+            const f32 radians = rotate_radians + (((f32)i * TAU) / (f32)polygon->len_points);
+            polygon->points[i] = (Vec2f){
+                center.x + (cosf(radians) * radius),
+                center.y + (sinf(radians) * radius),
+            };
+        }
+    }
+}
+
+// NOTE: Even-odd rule; points right on the boundary may land on either side.
+static Bool polygon_inside(const Polygon* polygon, Vec2f point) {
+    Bool inside = FALSE;
+    for (u32 i = 0; i < polygon->len_points; ++i) {
+        const Vec2f a = polygon->points[i];
+        const Vec2f b = polygon->points[(i + 1) % polygon->len_points];
+        if ((point.y < a.y) == (point.y < b.y)) {
+            continue;
+        }
+        if (point.x < (a.x + (((point.y - a.y) * (b.x - a.x)) / (b.y - a.y)))) {
+            inside = inside ? FALSE : TRUE;
+        }
+    }
+    return inside;
+}
+
+static u32 polygon_mask(const Polygon* polygon) {
+    return (u32)((((u64)1) << polygon->len_points) - 1);
+}
+
+static Vec2f polygon_center(const Polygon* polygon) {
+    Vec2f center = {0};
+    for (u32 i = 0; i < polygon->len_points; ++i) {
+        center.x += polygon->points[i].x;
+        center.y += polygon->points[i].y;
+    }
+    return (Vec2f){center.x / (f32)polygon->len_points, center.y / (f32)polygon->len_points};
+}
+
+// NOTE: Writes `polygon->len_points` triangles fanning out from the polygon's center.
+static void polygon_triangles(const Polygon* polygon, Vec4f color, Triangle* triangles) {
+    const Vec2f center = polygon_center(polygon);
+    for (u32 i = 0; i < polygon->len_points; ++i) {
+        triangles[i] = (Triangle){{
+            {center, color},
+            {polygon->points[i], color},
+            {polygon->points[(i + 1) % polygon->len_points], color},
+        }};
+    }
+}
+
+// NOTE: Proper crossings only; segments that merely touch do not count.
+static Bool segments_cross(Vec2f a0, Vec2f a1, Vec2f b0, Vec2f b1) {
+    return ((((cross(a0, a1, b0) * cross(a0, a1, b1)) < 0.0f) &&
+             ((cross(b0, b1, a0) * cross(b0, b1, a1)) < 0.0f)))
+               ? TRUE
+               : FALSE;
+}
+
+static Bool pvs_edge_visible(const Chunk* neighbors,
+                             const Vec2f  cell[4],
+                             Vec2f        a,
+                             Vec2f        b,
+                             Vec2f        center) {
+    Vec2f min = {a.x < b.x ? a.x : b.x, a.y < b.y ? a.y : b.y};
+    Vec2f max = {a.x < b.x ? b.x : a.x, a.y < b.y ? b.y : a.y};
+
+    // NOTE: Rays are never cast further than `WINDOW_DIAGONAL`.
+    {
+        const f32 x = min.x < cell[2].x ? (cell[0].x < max.x ? 0.0f : cell[0].x - max.x)
+                                        : min.x - cell[2].x;
+        const f32 y = min.y < cell[2].y ? (cell[0].y < max.y ? 0.0f : cell[0].y - max.y)
+                                        : min.y - cell[2].y;
+        if ((WINDOW_DIAGONAL * WINDOW_DIAGONAL) < ((x * x) + (y * y))) {
+            return FALSE;
+        }
+    }
+
+    // NOTE: Geoms are convex, so an edge can only be seen from the side facing away from the
+    // geom's center; the cell is convex too, so checking its corners is enough.
+    {
+        const f32 inside = cross(a, b, center);
+        Bool      front = FALSE;
+        for (u32 i = 0; i < 4; ++i) {
+            if ((cross(a, b, cell[i]) * inside) < 0.0f) {
+                front = TRUE;
+            }
+        }
+        if (!front) {
+            return FALSE;
+        }
+    }
+
+    // NOTE: A single static edge hides this one from the whole cell if it properly crosses every
+    // segment between the cell's corners and this edge's endpoints; the crossing point along the
+    // blocker is a linear-fractional function of those endpoints, so its extremes are at the
+    // corners. Blockers are not fused together, so this stays conservative.
+    min = (Vec2f){min.x < cell[0].x ? min.x : cell[0].x, min.y < cell[0].y ? min.y : cell[0].y};
+    max = (Vec2f){cell[2].x < max.x ? max.x : cell[2].x, cell[2].y < max.y ? max.y : cell[2].y};
+    for (u32 i = 0; i < (PVS_SPAN * PVS_SPAN); ++i) {
+        for (u32 j = 0; j < neighbors[i].len_geoms; ++j) {
+            if (neighbors[i].spin[j]) {
+                continue;
+            }
+            for (u32 k = 0; k < 4; ++k) {
+                const Vec2f blocker[2] = {
+                    neighbors[i].quads[j].points[k],
+                    neighbors[i].quads[j].points[(k + 1) % 4],
+                };
+                if (((blocker[0].x < min.x) && (blocker[1].x < min.x)) ||
+                    ((max.x < blocker[0].x) && (max.x < blocker[1].x)) ||
+                    ((blocker[0].y < min.y) && (blocker[1].y < min.y)) ||
+                    ((max.y < blocker[0].y) && (max.y < blocker[1].y)))
+                {
+                    continue;
+                }
+                Bool hidden = TRUE;
+                for (u32 l = 0; hidden && (l < 4); ++l) {
+                    if ((!segments_cross(cell[l], a, blocker[0], blocker[1])) ||
+                        (!segments_cross(cell[l], b, blocker[0], blocker[1])))
+                    {
+                        hidden = FALSE;
+                    }
+                }
+                if (hidden) {
+                    return FALSE;
+                }
+            }
+        }
+    }
+    return TRUE;
+}
+
+static void chunk_pvs(Chunk* chunk) {
+    Chunk neighbors[PVS_SPAN * PVS_SPAN];
+    for (u32 i = 0; i < (PVS_SPAN * PVS_SPAN); ++i) {
+        const i32 col = (i32)chunk->col + (i32)(i % PVS_SPAN) - PVS_RADIUS;
+        const i32 row = (i32)chunk->row + (i32)(i / PVS_SPAN) - PVS_RADIUS;
+        if ((col < 0) || (CHUNK_COLS <= col) || (row < 0) || (CHUNK_ROWS <= row)) {
+            neighbors[i].len_geoms = 0;
+            continue;
+        }
+        chunk_generate(&neighbors[i], (u32)col, (u32)row);
+    }
+
+    for (u32 i = 0; i < PVS_CELLS; ++i) {
+        const f32   left = ((f32)(chunk->col * CHUNK_WIDTH)) +
+                         ((f32)(i % PVS_CELL_COLS) * (CHUNK_WIDTH / (f32)PVS_CELL_COLS));
+        const f32   top = ((f32)(chunk->row * CHUNK_HEIGHT)) +
+                        ((f32)(i / PVS_CELL_COLS) * (CHUNK_HEIGHT / (f32)PVS_CELL_ROWS));
+        const Vec2f cell[4] = {
+            {left, top},
+            {left + (CHUNK_WIDTH / (f32)PVS_CELL_COLS), top},
+            {left + (CHUNK_WIDTH / (f32)PVS_CELL_COLS), top + (CHUNK_HEIGHT / (f32)PVS_CELL_ROWS)},
+            {left, top + (CHUNK_HEIGHT / (f32)PVS_CELL_ROWS)},
+        };
+
+        u32 len_pvs = 0;
+        for (u32 j = 0; j < (PVS_SPAN * PVS_SPAN); ++j) {
+            for (u32 k = 0; k < neighbors[j].len_geoms; ++k) {
+                if (neighbors[j].spin[k]) {
+                    continue;
+                }
+                const Quad* quad = &neighbors[j].quads[k];
+                const Vec2f center = {
+                    (quad->points[0].x + quad->points[2].x) / 2.0f,
+                    (quad->points[0].y + quad->points[2].y) / 2.0f,
+                };
+
+                u32 edges = 0;
+                for (u32 l = 0; l < 4; ++l) {
+                    if (pvs_edge_visible(neighbors,
+                                         cell,
+                                         quad->points[l],
+                                         quad->points[(l + 1) % 4],
+                                         center))
+                    {
+                        edges |= 1u << l;
+                    }
+                }
+                if (edges == 0) {
+                    continue;
+                }
+
+                assert(len_pvs < CAP_PVS);
+                chunk->pvs[i][len_pvs++] = (u16)(((j / PVS_SPAN) << 9) | ((j % PVS_SPAN) << 6) |
+                                                 (k << 4) | edges);
+            }
+        }
+        chunk->len_pvs[i] = (u8)len_pvs;
+    }
+}
+
+// NOTE: A chunk's polygons are numbered after its geoms, so polygon `i` has the id of geom
+// `CAP_CHUNK_GEOMS + i`.
+static u32 geom_id(const Chunk* chunk, u32 index) {
+    return (((chunk->row * CHUNK_COLS) + chunk->col) * CAP_CHUNK_OCCLUDERS) + index;
+}
+
+static void chunk_load(Chunk* chunk, u32 col, u32 row) {
+    chunk_generate(chunk, col, row);
+    chunk_pvs(chunk);
+}
+
+static u32 chunk_distance(const Chunk* chunk, u32 col, u32 row) {
+    const u32 cols = chunk->col < col ? col - chunk->col : chunk->col - col;
+    const u32 rows = chunk->row < row ? row - chunk->row : chunk->row - row;
+    return cols < rows ? rows : cols;
+}
+
+// NOTE: How far from the camera's chunk chunks need to stay resident for a view of `screen`: as far
+// as the view reaches along either axis, plus one, so chunks get loaded before they come into view.
+static u32 chunks_radius(Vec2f screen) {
+    const u32 cols = (u32)ceilf((screen.x / 2.0f) / CHUNK_WIDTH);
+    const u32 rows = (u32)ceilf((screen.y / 2.0f) / CHUNK_HEIGHT);
+    const u32 radius = (cols < rows ? rows : cols) + 1;
+    assert(radius <= CHUNK_RADIUS_RESIDENT_MAX);
+    return radius;
+}
+
+// NOTE: Returns the slot that the chunk at `(c, r)` should be loaded into, or `CAP_CHUNKS` if it is
+// already resident. Free slots go first; once all `CAP_CHUNKS` are taken, the slot of the chunk
+// farthest from the camera's chunk `(col, row)` gets recycled, which must be further than `radius`.
+static u32 chunks_slot(const Chunk* chunks, u32 col, u32 row, u32 radius, u32 c, u32 r) {
+    u32 slot = CAP_CHUNKS;
+    u32 farthest = 0;
+    for (u32 i = 0; i < CAP_CHUNKS; ++i) {
+        if (chunks[i].loaded && (chunks[i].col == c) && (chunks[i].row == r)) {
+            return CAP_CHUNKS;
+        }
+        const u32 distance = chunks[i].loaded ? chunk_distance(&chunks[i], col, row) : UINT32_MAX;
+        if ((slot == CAP_CHUNKS) || (farthest < distance)) {
+            slot = i;
+            farthest = distance;
+        }
+    }
+    assert(!chunks[slot].loaded || (radius < farthest));
+    return slot;
+}
+
+// NOTE: Loads every chunk within `radius` of the camera's chunk right away, on the calling thread;
+// the frame loop only does this once, before the first frame, and leaves the rest to the `Loader`.
+static u32 chunks_stream(Chunk* chunks, u32 col, u32 row, u32 radius) {
+    u32 len_loads = 0;
+    for (i32 r = (i32)row - (i32)radius; r <= ((i32)row + (i32)radius); ++r) {
+        if ((r < 0) || (CHUNK_ROWS <= r)) {
+            continue;
+        }
+        for (i32 c = (i32)col - (i32)radius; c <= ((i32)col + (i32)radius); ++c) {
+            if ((c < 0) || (CHUNK_COLS <= c)) {
+                continue;
+            }
+            const u32 slot = chunks_slot(chunks, col, row, radius, (u32)c, (u32)r);
+            if (slot == CAP_CHUNKS) {
+                continue;
+            }
+            chunk_load(&chunks[slot], (u32)c, (u32)r);
+            ++len_loads;
+        }
+    }
+    return len_loads;
+}
+
+static void* loader_run(void* argument) {
+    Loader* loader = argument;
+    Chunk   chunk;
+    assert(pthread_mutex_lock(&loader->mutex) == 0);
+    for (;;) {
+        while ((!loader->quit) && (loader->len_requests == 0)) {
+            assert(pthread_cond_wait(&loader->wake, &loader->mutex) == 0);
+        }
+        if (loader->quit) {
+            break;
+        }
+        const Coord coord = loader->requests[0];
+        --loader->len_requests;
+        memmove(&loader->requests[0], &loader->requests[1], sizeof(Coord) * loader->len_requests);
+        assert(pthread_mutex_unlock(&loader->mutex) == 0);
+
+        chunk_load(&chunk, coord.col, coord.row);
+
+        assert(pthread_mutex_lock(&loader->mutex) == 0);
+        assert(loader->len_ready < CAP_LOADS);
+        loader->ready[loader->len_ready++] = chunk;
+    }
+    assert(pthread_mutex_unlock(&loader->mutex) == 0);
+    return NULL;
+}
+
+static void loader_start(Loader* loader) {
+    loader->len_ready = 0;
+    loader->len_requests = 0;
+    loader->len_pending = 0;
+    loader->quit = FALSE;
+    assert(pthread_mutex_init(&loader->mutex, NULL) == 0);
+    assert(pthread_cond_init(&loader->wake, NULL) == 0);
+    assert(pthread_create(&loader->thread, NULL, loader_run, loader) == 0);
+}
+
+static void loader_stop(Loader* loader) {
+    assert(pthread_mutex_lock(&loader->mutex) == 0);
+    loader->quit = TRUE;
+    assert(pthread_cond_signal(&loader->wake) == 0);
+    assert(pthread_mutex_unlock(&loader->mutex) == 0);
+    assert(pthread_join(loader->thread, NULL) == 0);
+    assert(pthread_cond_destroy(&loader->wake) == 0);
+    assert(pthread_mutex_destroy(&loader->mutex) == 0);
+}
+
+static Bool coord_near(Coord coord, u32 col, u32 row, u32 radius) {
+    const u32 cols = coord.col < col ? col - coord.col : coord.col - col;
+    const u32 rows = coord.row < row ? row - coord.row : coord.row - row;
+    return ((cols <= radius) && (rows <= radius)) ? TRUE : FALSE;
+}
+
+static void loader_forget(Loader* loader, Coord coord) {
+    for (u32 i = 0; i < loader->len_pending; ++i) {
+        if ((loader->pending[i].col == coord.col) && (loader->pending[i].row == coord.row)) {
+            loader->pending[i] = loader->pending[--loader->len_pending];
+            return;
+        }
+    }
+}
+
+// NOTE: The frame loop's side of the `Loader`, which never blocks on chunks being generated: it
+// moves chunks that have finished loading into their slots, drops requests the camera has since
+// moved away from, and queues up whichever chunks within `radius` are still missing, nearest first.
+// Returns how many chunks were moved in.
+static u32 loader_stream(Loader* loader, Chunk* chunks, u32 col, u32 row, u32 radius) {
+    u32 len_loads = 0;
+    assert(pthread_mutex_lock(&loader->mutex) == 0);
+
+    for (u32 i = 0; i < loader->len_ready; ++i) {
+        const Chunk* chunk = &loader->ready[i];
+        loader_forget(loader, (Coord){chunk->col, chunk->row});
+        if (!coord_near((Coord){chunk->col, chunk->row}, col, row, radius)) {
+            continue;
+        }
+        const u32 slot = chunks_slot(chunks, col, row, radius, chunk->col, chunk->row);
+        if (slot == CAP_CHUNKS) {
+            continue;
+        }
+        chunks[slot] = *chunk;
+        ++len_loads;
+    }
+    loader->len_ready = 0;
+
+    for (u32 i = 0; i < loader->len_requests;) {
+        if (coord_near(loader->requests[i], col, row, radius)) {
+            ++i;
+            continue;
+        }
+        loader_forget(loader, loader->requests[i]);
+        --loader->len_requests;
+        memmove(&loader->requests[i],
+                &loader->requests[i + 1],
+                sizeof(Coord) * (loader->len_requests - i));
+    }
+
+    for (i32 d = 0; d <= (i32)radius; ++d) {
+        for (i32 r = (i32)row - d; r <= ((i32)row + d); ++r) {
+            for (i32 c = (i32)col - d; c <= ((i32)col + d); ++c) {
+                if ((r < 0) || (CHUNK_ROWS <= r) || (c < 0) || (CHUNK_COLS <= c) ||
+                    ((abs(r - (i32)row) != d) && (abs(c - (i32)col) != d)) ||
+                    (loader->len_pending == CAP_LOADS))
+                {
+                    continue;
+                }
+                const Coord coord = {(u32)c, (u32)r};
+                if (chunks_slot(chunks, col, row, radius, coord.col, coord.row) == CAP_CHUNKS) {
+                    continue;
+                }
+                Bool pending = FALSE;
+                for (u32 i = 0; i < loader->len_pending; ++i) {
+                    if ((loader->pending[i].col == coord.col) &&
+                        (loader->pending[i].row == coord.row))
+                    {
+                        pending = TRUE;
+                    }
+                }
+                if (pending) {
+                    continue;
+                }
+                loader->pending[loader->len_pending++] = coord;
+                loader->requests[loader->len_requests++] = coord;
+            }
+        }
+    }
+
+    if (loader->len_requests != 0) {
+        assert(pthread_cond_signal(&loader->wake) == 0);
+    }
+    assert(pthread_mutex_unlock(&loader->mutex) == 0);
+    return len_loads;
+}
+
+// NOTE: Hands out cache-line aligned slices of `arena->buffer` until it is reset. Running out of
+// space is not fatal; the caller gets `NULL`, the event is counted, and whichever stage asked for
+// the memory is skipped for the frame.
+static void* arena_alloc(Arena* arena, u64 size) {
+    const u64 offset = (arena->len + (CACHE_LINE - 1)) & ~((u64)(CACHE_LINE - 1));
+    if (arena->cap < (offset + size)) {
+        ++arena->overflows;
+        return NULL;
+    }
+    arena->len = offset + size;
+    if (arena->high_water < arena->len) {
+        arena->high_water = arena->len;
+    }
+    return &arena->buffer[offset];
+}
+
+// NOTE: The table is sized to at least twice `cap_vertices`, so probing always finds a free slot.
+static Occluders occluders_alloc(Arena* arena, u32 cap_vertices, u32 cap_edges) {
+    u32 cap_table = 1;
+    while (cap_table < (cap_vertices * 2)) {
+        cap_table <<= 1;
+    }
+    Occluders occluders = {
+        .vertices = arena_alloc(arena, sizeof(Vec2f) * cap_vertices),
+        .edges = arena_alloc(arena, sizeof(Edge) * cap_edges),
+        .table = arena_alloc(arena, sizeof(u32) * cap_table),
+        .cap_vertices = cap_vertices,
+        .cap_edges = cap_edges,
+        .cap_table = cap_table,
+    };
+    if (occluders.table) {
+        memset(occluders.table, 0, sizeof(u32) * cap_table);
+    }
+    return occluders;
+}
+
+static u32 occluders_vertex(Occluders* occluders, Vec2f point) {
+    const i32 x = (i32)roundf(point.x * VERTEX_SNAP);
+    const i32 y = (i32)roundf(point.y * VERTEX_SNAP);
+    for (u32 i = hash((u32)x ^ hash((u32)y));; ++i) {
+        u32* slot = &occluders->table[i & (occluders->cap_table - 1)];
+        if (*slot == 0) {
+            assert(occluders->len_vertices < occluders->cap_vertices);
+            occluders->vertices[occluders->len_vertices++] = point;
+            *slot = occluders->len_vertices;
+            return *slot - 1;
+        }
+        const Vec2f vertex = occluders->vertices[*slot - 1];
+        if ((x == (i32)roundf(vertex.x * VERTEX_SNAP)) &&
+            (y == (i32)roundf(vertex.y * VERTEX_SNAP)))
+        {
+            return *slot - 1;
+        }
+    }
+}
+
+// NOTE: Adds the closed polygon `points` (of either winding) to `occluders`, keeping only those of
+// its edges that are set in `mask` and face `viewer`. A ray from a viewer outside of the polygon
+// always enters it through a front-facing edge first, so the others can never clip it; likewise,
+// only corners of kept edges can ever bound what the viewer sees, and those shared between edges
+// (or polygons) are stored, and so cast rays, only once.
+// Without a `viewer`, every edge in `mask` is kept, which is what queries from arbitrary origins
+// (e.g. `raycast`) need; those edges are wound so that the polygon's inside is to their left, which
+// is what `occluders_copy` relies on.
+static void occluders_push(Occluders*   occluders,
+                           const Vec2f* viewer,
+                           const Vec2f* points,
+                           u32          len_points,
+                           u32          mask,
+                           u32          id) {
+    assert(len_points <= CAP_POLYGON_POINTS);
+
+    f32 area = 0.0f;
+    for (u32 i = 1; (i + 1) < len_points; ++i) {
+        area += cross(points[0], points[i], points[i + 1]);
+    }
+    for (u32 i = 0; i < len_points; ++i) {
+        if (!(mask & (1u << i))) {
+            continue;
+        }
+        const Vec2f a = points[i];
+        const Vec2f b = points[(i + 1) % len_points];
+        if (viewer && (0.0f <= (cross(a, b, *viewer) * area))) {
+            continue;
+        }
+        assert(occluders->len_edges < occluders->cap_edges);
+        const u32 from = occluders_vertex(occluders, a);
+        const u32 to = occluders_vertex(occluders, b);
+        occluders->edges[occluders->len_edges++] = (Edge){
+            (viewer || (0.0f < area)) ? from : to,
+            (viewer || (0.0f < area)) ? to : from,
+            id,
+        };
+    }
+}
+
+// NOTE: Like `occluders_push` without a viewer, except the corners get vertices of their own rather
+// than being looked up, so they can be dropped again by cutting `len_vertices` short.
+static void occluders_append(Occluders* occluders, const Vec2f* points, u32 len_points, u32 id) {
+    assert(len_points <= CAP_POLYGON_POINTS);
+    assert((occluders->len_vertices + len_points) <= occluders->cap_vertices);
+    assert((occluders->len_edges + len_points) <= occluders->cap_edges);
+
+    f32 area = 0.0f;
+    for (u32 i = 1; (i + 1) < len_points; ++i) {
+        area += cross(points[0], points[i], points[i + 1]);
+    }
+    const u32 first = occluders->len_vertices;
+    for (u32 i = 0; i < len_points; ++i) {
+        occluders->vertices[occluders->len_vertices++] = points[i];
+    }
+    for (u32 i = 0; i < len_points; ++i) {
+        const u32 from = first + i;
+        const u32 to = first + ((i + 1) % len_points);
+        occluders->edges[occluders->len_edges++] = (Edge){
+            (0.0f < area) ? from : to,
+            (0.0f < area) ? to : from,
+            id,
+        };
+    }
+}
+
+// NOTE: Adds the edges `[first, first + len_edges)` of `store` to `occluders`, keeping only those
+// set in `mask` (counted from `first`) that face `viewer`; see `occluders_push`.
+static void occluders_copy(Occluders*       occluders,
+                           const Occluders* store,
+                           u32              first,
+                           u32              len_edges,
+                           u32              mask,
+                           Vec2f            viewer) {
+    assert(len_edges <= CAP_POLYGON_POINTS);
+    for (u32 i = 0; i < len_edges; ++i) {
+        if (!(mask & (1u << i))) {
+            continue;
+        }
+        const Vec2f a = store->vertices[store->edges[first + i].from];
+        const Vec2f b = store->vertices[store->edges[first + i].to];
+        if (0.0f <= cross(a, b, viewer)) {
+            continue;
+        }
+        assert(occluders->len_edges < occluders->cap_edges);
+        occluders->edges[occluders->len_edges++] = (Edge){
+            occluders_vertex(occluders, a),
+            occluders_vertex(occluders, b),
+            store->edges[first + i].id,
+        };
+    }
+}
+
+static void store_open(Store* store) {
+    *store = (Store){
+        .arena =
+            {
+                .buffer = mmap(NULL,
+                               CAP_STORE_ARENA,
+                               PROT_READ | PROT_WRITE,
+                               MAP_PRIVATE | MAP_ANONYMOUS,
+                               -1,
+                               0),
+                .cap = CAP_STORE_ARENA,
+            },
+    };
+    assert(store->arena.buffer != MAP_FAILED);
+}
+
+static void store_close(Store* store) {
+    assert(munmap(store->arena.buffer, CAP_STORE_ARENA) == 0);
+}
+
+// NOTE: Rebuilds `store` from scratch whenever a chunk was (un)loaded since the last call, then
+// (re)adds the edges of every spinning geom where it has turned to by now.
+static void store_update(Store* store, const Chunk* chunks) {
+    u32 signature = 0;
+    for (u32 i = 0; i < CAP_CHUNKS; ++i) {
+        if (chunks[i].loaded) {
+            signature =
+                hash(signature ^ ((((chunks[i].row * CHUNK_COLS) + chunks[i].col) * CAP_CHUNKS) +
+                                  i + 1));
+        }
+    }
+
+    Occluders* occluders = &store->occluders;
+    if ((!store->built) || (store->signature != signature)) {
+        store->arena.len = 0;
+        *occluders = occluders_alloc(&store->arena, CAP_STORE, CAP_STORE);
+        assert(occluders->vertices && occluders->edges && occluders->table);
+        memset(store->firsts, 0, sizeof(store->firsts));
+        memset(store->lens, 0, sizeof(store->lens));
+
+        for (u32 i = 0; i < CAP_CHUNKS; ++i) {
+            if (!chunks[i].loaded) {
+                continue;
+            }
+            for (u32 j = 0; j < chunks[i].len_geoms; ++j) {
+                if (chunks[i].spin[j]) {
+                    continue;
+                }
+                store->firsts[i][j] = occluders->len_edges;
+                occluders_push(occluders,
+                               NULL,
+                               chunks[i].quads[j].points,
+                               4,
+                               0xF,
+                               geom_id(&chunks[i], j));
+                store->lens[i][j] = occluders->len_edges - store->firsts[i][j];
+            }
+            for (u32 j = 0; j < chunks[i].len_polygons; ++j) {
+                const u32 k = CAP_CHUNK_GEOMS + j;
+                store->firsts[i][k] = occluders->len_edges;
+                occluders_push(occluders,
+                               NULL,
+                               chunks[i].polygons[j].points,
+                               chunks[i].polygons[j].len_points,
+                               polygon_mask(&chunks[i].polygons[j]),
+                               geom_id(&chunks[i], k));
+                store->lens[i][k] = occluders->len_edges - store->firsts[i][k];
+            }
+        }
+        const Vec2f border[4] = {
+            {0.0f, 0.0f},
+            {WORLD_WIDTH, 0.0f},
+            {WORLD_WIDTH, WORLD_HEIGHT},
+            {0.0f, WORLD_HEIGHT},
+        };
+        occluders_push(occluders, NULL, border, 4, 0xF, ID_WORLD);
+
+        store->len_vertices = occluders->len_vertices;
+        store->len_edges = occluders->len_edges;
+        store->signature = signature;
+        store->built = TRUE;
+    }
+
+    occluders->len_vertices = store->len_vertices;
+    occluders->len_edges = store->len_edges;
+    for (u32 i = 0; i < CAP_CHUNKS; ++i) {
+        for (u32 j = 0; chunks[i].loaded && (j < chunks[i].len_geoms); ++j) {
+            if (!chunks[i].spin[j]) {
+                continue;
+            }
+            const Quad quad = geom_to_quad(chunks[i].geoms[j]);
+            store->firsts[i][j] = occluders->len_edges;
+            occluders_append(occluders, quad.points, 4, geom_id(&chunks[i], j));
+            store->lens[i][j] = 4;
+        }
+    }
+}
+
+// NOTE: Casts every ray in `rays` against `occluders`, reporting the nearest hit within each ray's
+// `distance` (in world units; `direction` need not be normalized). `normal` is that of the edge
+// hit, facing back towards the ray's origin. Misses report the ray's full `distance`, a zero
+// `normal`, and `ID_NONE`. Like `query_visible`, rays are processed in lock-step blocks, here with
+// the edges in the outer loop, so every edge is loaded once per block and the inner loop is
+// branch-free.
+static void raycast(const Occluders* occluders, const Ray* rays, Hit* hits, u32 len_rays) {
+    for (u32 i = 0; i < len_rays; i += CAP_RAYS_BLOCK) {
+        const u32 len_block = (len_rays - i) < CAP_RAYS_BLOCK ? (len_rays - i) : CAP_RAYS_BLOCK;
+
+        f32 x[CAP_RAYS_BLOCK];
+        f32 y[CAP_RAYS_BLOCK];
+        f32 dx[CAP_RAYS_BLOCK];
+        f32 dy[CAP_RAYS_BLOCK];
+        f32 nearest[CAP_RAYS_BLOCK];
+        u32 edges[CAP_RAYS_BLOCK];
+        for (u32 j = 0; j < len_block; ++j) {
+            const Vec2f direction = normalize(rays[i + j].direction);
+            x[j] = rays[i + j].origin.x;
+            y[j] = rays[i + j].origin.y;
+            dx[j] = direction.x;
+            dy[j] = direction.y;
+            nearest[j] = rays[i + j].distance;
+            edges[j] = occluders->len_edges;
+        }
+
+        for (u32 k = 0; k < occluders->len_edges; ++k) {
+            const Vec2f a = occluders->vertices[occluders->edges[k].from];
+            const Vec2f b = occluders->vertices[occluders->edges[k].to];
+            const f32   sx = b.x - a.x;
+            const f32   sy = b.y - a.y;
+            for (u32 j = 0; j < len_block; ++j) {
+                const f32 qx = a.x - x[j];
+                const f32 qy = a.y - y[j];
+                const f32 denominator = (dx[j] * sy) - (dy[j] * sx);
+                const f32 divisor = denominator == 0.0f ? 1.0f : denominator;
+                const f32 t = ((qx * sy) - (qy * sx)) / divisor;
+                const f32 u = ((qx * dy[j]) - (qy * dx[j])) / divisor;
+                const Bool hit = ((denominator != 0.0f) && (0.0f <= t) && (t < nearest[j]) &&
+                                  (0.0f <= u) && (u <= 1.0f))
+                                     ? TRUE
+                                     : FALSE;
+                nearest[j] = hit ? t : nearest[j];
+                edges[j] = hit ? k : edges[j];
+            }
+        }
+
+        for (u32 j = 0; j < len_block; ++j) {
+            if (edges[j] == occluders->len_edges) {
+                hits[i + j] = (Hit){{0}, nearest[j], ID_NONE};
+                continue;
+            }
+            const Edge* edge = &occluders->edges[edges[j]];
+            const Vec2f a = occluders->vertices[edge->from];
+            const Vec2f b = occluders->vertices[edge->to];
+            Vec2f       normal = normalize((Vec2f){a.y - b.y, b.x - a.x});
+            if (0.0f < ((normal.x * dx[j]) + (normal.y * dy[j]))) {
+                normal = (Vec2f){-normal.x, -normal.y};
+            }
+            hits[i + j] = (Hit){normal, nearest[j], edge->id};
+        }
+    }
+}
+
+// NOTE: Checks every chunk polygon two ways, each from `BENCH_POLYGON_VIEWERS` viewers around it:
+// - On its own, copied out of `store` and culled for the viewer the way the frame loop does it, it
+//   must stop every ray aimed along one of its edges right where the unculled polygon does, and it
+//   must stop the ray aimed at its center.
+// - In `store`, which holds every chunk unculled, that ray must hit something before the center.
+// Returns how many polygons were checked.
+static u32 bench_polygons(Arena* arena, const Store* store, const Chunk* chunks) {
+    const u64 len_arena = arena->len;
+    u32       len_polygons = 0;
+    for (u32 i = 0; i < CAP_CHUNKS; ++i) {
+        if (!chunks[i].loaded) {
+            continue;
+        }
+        for (u32 j = 0; j < chunks[i].len_polygons; ++j) {
+            const Polygon* polygon = &chunks[i].polygons[j];
+            const u32      first = store->firsts[i][CAP_CHUNK_GEOMS + j];
+            const u32      len_edges = store->lens[i][CAP_CHUNK_GEOMS + j];
+            const u32      id = geom_id(&chunks[i], CAP_CHUNK_GEOMS + j);
+            const Vec2f    center = polygon_center(polygon);
+
+            f32 outer = 0.0f;
+            for (u32 k = 0; k < polygon->len_points; ++k) {
+                const f32 x = polygon->points[k].x - center.x;
+                const f32 y = polygon->points[k].y - center.y;
+                outer = fmaxf(outer, sqrtf((x * x) + (y * y)));
+            }
+
+            for (u32 k = 0; k < BENCH_POLYGON_VIEWERS; ++k) {
+                const f32   radians = ((f32)k * TAU) / BENCH_POLYGON_VIEWERS;
+                const Vec2f viewer = {
+                    center.x + (cosf(radians) * outer * 2.0f),
+                    center.y + (sinf(radians) * outer * 2.0f),
+                };
+                assert(!polygon_inside(polygon, viewer));
+
+                arena->len = len_arena;
+                Occluders culled = occluders_alloc(arena, CAP_POLYGON_POINTS, CAP_POLYGON_POINTS);
+                Occluders unculled =
+                    occluders_alloc(arena, CAP_POLYGON_POINTS, CAP_POLYGON_POINTS);
+                const u32 cap_rays = (CAP_POLYGON_POINTS * 3) + 1;
+                Ray*      rays = arena_alloc(arena, sizeof(Ray) * cap_rays);
+                Hit*      hits_culled = arena_alloc(arena, sizeof(Hit) * cap_rays);
+                Hit*      hits_unculled = arena_alloc(arena, sizeof(Hit) * cap_rays);
+                assert(culled.vertices && culled.edges && culled.table);
+                assert(unculled.vertices && unculled.edges && unculled.table);
+                assert(rays && hits_culled && hits_unculled);
+
+                occluders_copy(&culled, &store->occluders, first, len_edges, UINT32_MAX, viewer);
+                occluders_push(&unculled,
+                               NULL,
+                               polygon->points,
+                               polygon->len_points,
+                               polygon_mask(polygon),
+                               id);
+                assert(culled.len_edges < unculled.len_edges);
+
+                // NOTE: Rays aimed right at a corner graze it, and whether they count as hitting
+                // either edge meeting there is down to rounding; these aim a hundredth of an edge
+                // away from either end instead, and at its middle.
+                u32 len_rays = 0;
+                for (u32 l = 0; l < polygon->len_points; ++l) {
+                    const Vec2f a = polygon->points[l];
+                    const Vec2f b = polygon->points[(l + 1) % polygon->len_points];
+                    for (u32 m = 0; m < 3; ++m) {
+                        const f32   t = m == 0 ? 0.01f : m == 1 ? 0.5f : 0.99f;
+                        const Vec2f point = {a.x + ((b.x - a.x) * t), a.y + ((b.y - a.y) * t)};
+                        rays[len_rays++] = (Ray){
+                            viewer,
+                            {point.x - viewer.x, point.y - viewer.y},
+                            WINDOW_DIAGONAL,
+                        };
+                    }
+                }
+                rays[len_rays++] = (Ray){
+                    viewer,
+                    {center.x - viewer.x, center.y - viewer.y},
+                    WINDOW_DIAGONAL,
+                };
+
+                raycast(&culled, rays, hits_culled, len_rays);
+                raycast(&unculled, rays, hits_unculled, len_rays);
+                for (u32 l = 0; l < len_rays; ++l) {
+                    assert(hits_culled[l].id == hits_unculled[l].id);
+                    assert(fabsf(hits_culled[l].distance - hits_unculled[l].distance) < 0.001f);
+                }
+                assert(hits_culled[len_rays - 1].id == id);
+
+                raycast(&store->occluders, &rays[len_rays - 1], hits_culled, 1);
+                assert(hits_culled[0].id != ID_NONE);
+                assert(hits_culled[0].distance < (outer * 2.0f));
+            }
+            ++len_polygons;
+        }
+    }
+    arena->len = len_arena;
+    return len_polygons;
+}
+
+// NOTE: Headless; casts `CAP_BENCH_RAYS` random rays against every resident chunk around the
+// world's center for about a second, and reports the throughput of `raycast`. The polygons among
+// those chunks get checked with `bench_polygons` first.
+static i32 bench(void) {
+    static Chunk chunks[CAP_CHUNKS];
+    const u32    radius = chunks_radius((Vec2f){WINDOW_WIDTH, WINDOW_HEIGHT});
+    chunks_stream(chunks, CHUNK_COLS / 2, CHUNK_ROWS / 2, radius);
+
+    Arena arena = {
+        .buffer =
+            mmap(NULL, CAP_BENCH_ARENA, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0),
+        .cap = CAP_BENCH_ARENA,
+    };
+    assert(arena.buffer != MAP_FAILED);
+
+    Store store;
+    store_open(&store);
+    store_update(&store, chunks);
+    const Occluders* occluders = &store.occluders;
+
+    Ray* rays = arena_alloc(&arena, sizeof(Ray) * CAP_BENCH_RAYS);
+    Hit* hits = arena_alloc(&arena, sizeof(Hit) * CAP_BENCH_RAYS);
+    assert(rays && hits);
+
+    const u32 len_polygons = bench_polygons(&arena, &store, chunks);
+
+    u32 state = 1;
+    for (u32 i = 0; i < CAP_BENCH_RAYS; ++i) {
+        const f32 radians = random_f32(&state) * TAU;
+        rays[i] = (Ray){
+            {
+                ((f32)(((CHUNK_COLS / 2) - radius) * CHUNK_WIDTH)) +
+                    (random_f32(&state) * (f32)(((radius * 2) + 1) * CHUNK_WIDTH)),
+                ((f32)(((CHUNK_ROWS / 2) - radius) * CHUNK_HEIGHT)) +
+                    (random_f32(&state) * (f32)(((radius * 2) + 1) * CHUNK_HEIGHT)),
+            },
+            {cosf(radians), sinf(radians)},
+            WINDOW_DIAGONAL,
+        };
+    }
+
+    raycast(occluders, rays, hits, CAP_BENCH_RAYS);
+
+    u64 len_rays = 0;
+    u64 start = now();
+    u64 elapsed = 0;
+    while (elapsed < NANOS_PER_SECOND) {
+        raycast(occluders, rays, hits, CAP_BENCH_RAYS);
+        len_rays += CAP_BENCH_RAYS;
+        elapsed = now() - start;
+    }
+
+    u32 len_hits = 0;
+    for (u32 i = 0; i < CAP_BENCH_RAYS; ++i) {
+        if (hits[i].id != ID_NONE) {
+            ++len_hits;
+        }
+    }
+
+    printf("%9u polygons checked\n"
+           "%9u edges\n"
+           "%9lu rays\n"
+           "%9.0f rays/s\n"
+           "%9.2f ns/ray\n"
+           "%9.2f ns/(ray * edge)\n"
+           "%9.1f %% hit\n",
+           len_polygons,
+           occluders->len_edges,
+           len_rays,
+           ((f64)len_rays * NANOS_PER_SECOND) / (f64)elapsed,
+           (f64)elapsed / (f64)len_rays,
+           (f64)elapsed / ((f64)len_rays * occluders->len_edges),
+           ((f64)len_hits * 100.0) / CAP_BENCH_RAYS);
+
+    store_close(&store);
+    assert(munmap(arena.buffer, CAP_BENCH_ARENA) == 0);
+    return 0;
+}
+
+// NOTE: Clips the rays `[len_points * index / len_threads, len_points * (index + 1) / len_threads)`
+// of `rays`, so that each of `len_threads` callers writes a disjoint slice of `points`.
+static void rays_cast(const Rays* rays, u32 index, u32 len_threads) {
+    const u32 first = (u32)(((u64)rays->len_points * index) / len_threads);
+    const u32 last = (u32)(((u64)rays->len_points * (index + 1)) / len_threads);
+    for (u32 i = first; i < last; ++i) {
+        Vec2f a[2] = {rays->origin, rays->points[i]};
+        for (u32 j = 0; j < rays->occluders->len_edges; ++j) {
+            const Vec2f b[2] = {
+                rays->occluders->vertices[rays->occluders->edges[j].from],
+                rays->occluders->vertices[rays->occluders->edges[j].to],
+            };
+            intersect(a, b, &rays->points[i]);
+            a[1] = rays->points[i];
+        }
+        for (u32 j = 0; j < 4; ++j) {
+            a[1] = rays->points[i];
+            const Vec2f b[2] = {
+                rays->border[j].translate,
+                {
+                    rays->border[j].translate.x + rays->border[j].scale.x,
+                    rays->border[j].translate.y + rays->border[j].scale.y,
+                },
+            };
+            intersect(a, b, &rays->points[i]);
+        }
+    }
+}
+
+static void* worker_run(void* argument) {
+    const Worker* worker = argument;
+    Pool*         pool = worker->pool;
+    for (;;) {
+        pthread_barrier_wait(&pool->start);
+        if (pool->quit) {
+            return NULL;
+        }
+        pool->job(pool->argument, worker->index, pool->len_threads);
+        pthread_barrier_wait(&pool->stop);
+    }
+}
+
+// NOTE: Workers stay parked on `start` between jobs; the calling thread always takes index `0`
+// itself, so `len_threads - 1` workers get spawned.
+static void pool_start(Pool* pool, Worker* workers, u32 cap_threads) {
+    assert(0 < cap_threads);
+    assert(cap_threads <= CAP_THREADS);
+    const i64 len_cores = sysconf(_SC_NPROCESSORS_ONLN);
+    pool->len_threads = len_cores < 1 ? 1 : cap_threads < len_cores ? cap_threads : (u32)len_cores;
+    pool->quit = FALSE;
+    pool->pairs_min = UINT64_MAX;
+    assert(pthread_barrier_init(&pool->start, NULL, pool->len_threads) == 0);
+    assert(pthread_barrier_init(&pool->stop, NULL, pool->len_threads) == 0);
+    for (u32 i = 1; i < pool->len_threads; ++i) {
+        workers[i] = (Worker){.pool = pool, .index = i};
+        assert(pthread_create(&workers[i].thread, NULL, worker_run, &workers[i]) == 0);
+    }
+}
+
+static void pool_stop(Pool* pool, Worker* workers) {
+    pool->quit = TRUE;
+    pthread_barrier_wait(&pool->start);
+    for (u32 i = 1; i < pool->len_threads; ++i) {
+        assert(pthread_join(workers[i].thread, NULL) == 0);
+    }
+    assert(pthread_barrier_destroy(&pool->start) == 0);
+    assert(pthread_barrier_destroy(&pool->stop) == 0);
+}
+
+// NOTE: Runs `job` on every thread of `pool` at once and returns when all of them are done.
+static void pool_run(Pool* pool, Job job, void* argument) {
+    pool->job = job;
+    pool->argument = argument;
+    pthread_barrier_wait(&pool->start);
+    job(argument, 0, pool->len_threads);
+    pthread_barrier_wait(&pool->stop);
+}
+
+static void rays_job(void* argument, u32 index, u32 len_threads) {
+    rays_cast(argument, index, len_threads);
+}
+
+static void pool_idle(void* argument, u32 index, u32 len_threads) {
+    (void)argument;
+    (void)index;
+    (void)len_threads;
+}
+
+// NOTE: Measures what a round trip through the barriers costs against what a single ray-edge test
+// costs, and from that sets `pairs_min`, the number of ray-edge tests a cast needs before splitting
+// it across `len_threads` threads saves more than waking them takes. Both sides are measured on
+// this machine because the ratio between them varies widely across cores and schedulers.
+static void pool_calibrate(Pool* pool, const Geom* border) {
+    if (pool->len_threads < 2) {
+        return;
+    }
+
+    pool_run(pool, pool_idle, NULL);
+    u64 wake_nanos = UINT64_MAX;
+    for (u32 i = 0; i < POOL_CALIBRATE_RUNS; ++i) {
+        const u64 start = now();
+        pool_run(pool, pool_idle, NULL);
+        const u64 elapsed = now() - start;
+        wake_nanos = elapsed < wake_nanos ? elapsed : wake_nanos;
+    }
+
+    // NOTE: A fan of rays against a row of short edges, most of which every ray misses; that is
+    // what a viewer's occluders mostly look like once they have been culled.
+    Vec2f vertices[POOL_CALIBRATE_EDGES * 2];
+    Edge  edges[POOL_CALIBRATE_EDGES];
+    for (u32 i = 0; i < POOL_CALIBRATE_EDGES; ++i) {
+        vertices[i * 2] = (Vec2f){(f32)i * 16.0f, 256.0f};
+        vertices[(i * 2) + 1] = (Vec2f){((f32)i * 16.0f) + 8.0f, 320.0f};
+        edges[i] = (Edge){.from = i * 2, .to = (i * 2) + 1, .id = i};
+    }
+    const Occluders occluders = {
+        .vertices = vertices,
+        .edges = edges,
+        .len_vertices = POOL_CALIBRATE_EDGES * 2,
+        .len_edges = POOL_CALIBRATE_EDGES,
+    };
+    Vec2f points[POOL_CALIBRATE_RAYS];
+    u64   cast_nanos = UINT64_MAX;
+    for (u32 i = 0; i < POOL_CALIBRATE_RUNS; ++i) {
+        for (u32 j = 0; j < POOL_CALIBRATE_RAYS; ++j) {
+            points[j] = (Vec2f){(f32)j * 4.0f, 1024.0f};
+        }
+        const Rays rays = {
+            .origin = {512.0f, 64.0f},
+            .occluders = &occluders,
+            .border = border,
+            .points = points,
+            .len_points = POOL_CALIBRATE_RAYS,
+        };
+        const u64 start = now();
+        rays_cast(&rays, 0, 1);
+        const u64 elapsed = now() - start;
+        cast_nanos = elapsed < cast_nanos ? elapsed : cast_nanos;
+    }
+
+    const f64 pair_nanos =
+        ((f64)cast_nanos) / ((f64)POOL_CALIBRATE_RAYS * (POOL_CALIBRATE_EDGES + 4));
+    // NOTE: Splitting saves `(1 - 1 / len_threads)` of the cast and costs one wake-up.
+    const f64 saved = pair_nanos * (1.0 - (1.0 / (f64)pool->len_threads));
+    pool->pairs_min = saved <= 0.0 ? UINT64_MAX : (u64)((f64)wake_nanos / saved) + 1;
+}
+
+// NOTE: Every ray is independent of the others, so the only synchronization needed is the pair of
+// barriers around the split. Returns how many threads took part.
+static u32 pool_cast(Pool* pool, Rays rays) {
+    const u64 pairs = (u64)rays.len_points * (rays.occluders->len_edges + 4);
+    if ((pool->len_threads < 2) || (pairs < pool->pairs_min)) {
+        rays_cast(&rays, 0, 1);
+        return 1;
+    }
+    pool_run(pool, rays_job, &rays);
+    return pool->len_threads;
+}
+
+static i32 compare_f32(const void* a, const void* b) {
+    const f32 x = *(const f32*)a;
+    const f32 y = *(const f32*)b;
+    return x < y ? -1 : y < x ? 1 : 0;
+}
+
+static i32 compare_u64(const void* a, const void* b) {
+    const u64 x = *(const u64*)a;
+    const u64 y = *(const u64*)b;
+    return x < y ? -1 : y < x ? 1 : 0;
+}
+
+// NOTE: Returns the fraction of the disc of `HEATMAP_RADIUS` around `origin` that can be seen from
+// it, `0` if it sits inside of an occluder. Rays are cast (with `raycast`) at every corner, at
+// every spot an edge crosses the disc's rim, and at every spot two edges cross one another
+// (occluders may overlap), so between neighboring rays the boundary of what is visible is either a
+// single edge (both rays hit something) or an arc of the rim (neither does); those pieces are
+// summed exactly as triangles and sectors.
+static f32 coverage(Arena* arena, const Polygon* polygons, u32 len_polygons, Vec2f origin) {
+    arena->len = 0;
+
+    u32 cap_edges = 4;
+    for (u32 i = 0; i < len_polygons; ++i) {
+        cap_edges += polygons[i].len_points;
+    }
+    Occluders occluders = occluders_alloc(arena, cap_edges, cap_edges);
+    assert(occluders.vertices && occluders.edges && occluders.table);
+    for (u32 i = 0; i < len_polygons; ++i) {
+        if (polygon_inside(&polygons[i], origin)) {
+            return 0.0f;
+        }
+        Vec2f min = polygons[i].points[0];
+        Vec2f max = polygons[i].points[0];
+        for (u32 j = 0; j < polygons[i].len_points; ++j) {
+            const Vec2f a = polygons[i].points[j];
+            min = (Vec2f){a.x < min.x ? a.x : min.x, a.y < min.y ? a.y : min.y};
+            max = (Vec2f){max.x < a.x ? a.x : max.x, max.y < a.y ? a.y : max.y};
+        }
+        const f32 x = clamp(origin.x, min.x, max.x) - origin.x;
+        const f32 y = clamp(origin.y, min.y, max.y) - origin.y;
+        if ((HEATMAP_RADIUS * HEATMAP_RADIUS) < ((x * x) + (y * y))) {
+            continue;
+        }
+        occluders_push(&occluders,
+                       &origin,
+                       polygons[i].points,
+                       polygons[i].len_points,
+                       polygon_mask(&polygons[i]),
+                       i);
+    }
+    {
+        const Vec2f border[4] = {
+            {0.0f, 0.0f},
+            {WORLD_WIDTH, 0.0f},
+            {WORLD_WIDTH, WORLD_HEIGHT},
+            {0.0f, WORLD_HEIGHT},
+        };
+        occluders_push(&occluders, NULL, border, 4, 0xF, ID_WORLD);
+    }
+
+    u32 len_crossings = 0;
+    for (u32 i = 0; i < occluders.len_edges; ++i) {
+        for (u32 j = i + 1; j < occluders.len_edges; ++j) {
+            if (segments_cross(occluders.vertices[occluders.edges[i].from],
+                               occluders.vertices[occluders.edges[i].to],
+                               occluders.vertices[occluders.edges[j].from],
+                               occluders.vertices[occluders.edges[j].to]))
+            {
+                ++len_crossings;
+            }
+        }
+    }
+
+    const u32 cap_angles =
+        ((occluders.len_vertices + (occluders.len_edges * 2) + len_crossings) * 3) + 4;
+    f32* angles = arena_alloc(arena, sizeof(f32) * cap_angles);
+    assert(angles);
+
+    u32 len_angles = 0;
+    for (u32 i = 0; i < 4; ++i) {
+        angles[len_angles++] = ((f32)i * (PI / 2.0f)) - PI;
+    }
+#define PUSH_ANGLE(x, y)                                   \
+    do {                                                   \
+        const f32 radians = atan2f(y, x);                  \
+        angles[len_angles++] = radians - EPSILON;          \
+        angles[len_angles++] = radians;                    \
+        angles[len_angles++] = radians + EPSILON;          \
+    } while (FALSE)
+    for (u32 i = 0; i < occluders.len_vertices; ++i) {
+        const f32 x = occluders.vertices[i].x - origin.x;
+        const f32 y = occluders.vertices[i].y - origin.y;
+        if (((x * x) + (y * y)) <= (HEATMAP_RADIUS * HEATMAP_RADIUS)) {
+            PUSH_ANGLE(x, y);
+        }
+    }
+    for (u32 i = 0; i < occluders.len_edges; ++i) {
+        const Vec2f a = occluders.vertices[occluders.edges[i].from];
+        const Vec2f b = occluders.vertices[occluders.edges[i].to];
+        const f32   dx = b.x - a.x;
+        const f32   dy = b.y - a.y;
+        const f32   px = a.x - origin.x;
+        const f32   py = a.y - origin.y;
+        const f32   qa = (dx * dx) + (dy * dy);
+        const f32   qb = 2.0f * ((px * dx) + (py * dy));
+        const f32   qc = ((px * px) + (py * py)) - (HEATMAP_RADIUS * HEATMAP_RADIUS);
+        const f32   discriminant = (qb * qb) - (4.0f * qa * qc);
+        if ((qa == 0.0f) || (discriminant < 0.0f)) {
+            continue;
+        }
+        for (u32 j = 0; j < 2; ++j) {
+            const f32 t = (-qb + (j == 0 ? -1.0f : 1.0f) * sqrtf(discriminant)) / (2.0f * qa);
+            if ((0.0f <= t) && (t <= 1.0f)) {
+                PUSH_ANGLE(px + (t * dx), py + (t * dy));
+            }
+        }
+    }
+    for (u32 i = 0; (len_crossings != 0) && (i < occluders.len_edges); ++i) {
+        const Vec2f a[2] = {
+            occluders.vertices[occluders.edges[i].from],
+            occluders.vertices[occluders.edges[i].to],
+        };
+        for (u32 j = i + 1; j < occluders.len_edges; ++j) {
+            const Vec2f b[2] = {
+                occluders.vertices[occluders.edges[j].from],
+                occluders.vertices[occluders.edges[j].to],
+            };
+            if (!segments_cross(a[0], a[1], b[0], b[1])) {
+                continue;
+            }
+            Vec2f point = a[0];
+            intersect(a, b, &point);
+            const f32 x = point.x - origin.x;
+            const f32 y = point.y - origin.y;
+            if (((x * x) + (y * y)) <= (HEATMAP_RADIUS * HEATMAP_RADIUS)) {
+                PUSH_ANGLE(x, y);
+            }
+        }
+    }
+#undef PUSH_ANGLE
+    assert(len_angles <= cap_angles);
+
+    qsort(angles, len_angles, sizeof(f32), compare_f32);
+
+    Ray* rays = arena_alloc(arena, sizeof(Ray) * len_angles);
+    Hit* hits = arena_alloc(arena, sizeof(Hit) * len_angles);
+    assert(rays && hits);
+    for (u32 i = 0; i < len_angles; ++i) {
+        rays[i] = (Ray){origin, {cosf(angles[i]), sinf(angles[i])}, HEATMAP_RADIUS};
+    }
+    raycast(&occluders, rays, hits, len_angles);
+
+    f32 area = 0.0f;
+    for (u32 i = 0; i < len_angles; ++i) {
+        const u32 j = (i + 1) % len_angles;
+        f32       radians = angles[j] - angles[i];
+        if (j == 0) {
+            radians += TAU;
+        }
+        if (radians <= 0.0f) {
+            continue;
+        }
+        if ((hits[i].id == ID_NONE) && (hits[j].id == ID_NONE)) {
+            area += (HEATMAP_RADIUS * HEATMAP_RADIUS * radians) / 2.0f;
+        } else {
+            area += (hits[i].distance * hits[j].distance * sinf(radians)) / 2.0f;
+        }
+    }
+    return area / (PI * HEATMAP_RADIUS * HEATMAP_RADIUS);
+}
+
+typedef struct {
+    const Polygon* polygons;
+    u32            len_polygons;
+    Vec2f          origin;
+    u32            cols;
+    u32            rows;
+    u32            stride;
+    u32            next;
+    f32*           areas;
+    Arena*         arenas;
+} Heatmap;
+
+// NOTE: Rows are handed out one at a time from a shared counter, so threads that land on cheap rows
+// just take more of them.
+static void heatmap_job(void* argument, u32 index, u32) {
+    Heatmap* heatmap = argument;
+    for (;;) {
+        const u32 row = __atomic_fetch_add(&heatmap->next, heatmap->stride, __ATOMIC_RELAXED);
+        if (heatmap->rows <= row) {
+            return;
+        }
+        for (u32 col = 0; col < heatmap->cols; ++col) {
+            const Vec2f origin = {
+                heatmap->origin.x + ((f32)col * HEATMAP_STEP) + (HEATMAP_STEP / 2.0f),
+                heatmap->origin.y + ((f32)row * HEATMAP_STEP) + (HEATMAP_STEP / 2.0f),
+            };
+            heatmap->areas[(row * heatmap->cols) + col] =
+                coverage(&heatmap->arenas[index], heatmap->polygons, heatmap->len_polygons, origin);
+        }
+    }
+}
+
+// NOTE: Headless; writes the coverage of every viewer position on the heatmap's grid both as an
+// image (`PATH_HEATMAP_IMAGE`, black where nothing is seen, white where everything is) and as raw
+// native-endian `f32`s, row by row (`PATH_HEATMAP_DATA`), then reports how fast the queries ran on
+// all threads against a single-threaded pass over a sample of the rows.
+static i32 heatmap(void) {
+    const u32 col = (CHUNK_COLS - HEATMAP_COLS) / 2;
+    const u32 row = (CHUNK_ROWS - HEATMAP_ROWS) / 2;
+
+    // NOTE: The margin may reach past the world's edges, so the bounds are signed and clamped.
+    const i32 row_first = (i32)row - (i32)HEATMAP_MARGIN_ROWS;
+    const i32 col_first = (i32)col - (i32)HEATMAP_MARGIN_COLS;
+    const i32 row_last = (i32)(row + HEATMAP_ROWS + HEATMAP_MARGIN_ROWS);
+    const i32 col_last = (i32)(col + HEATMAP_COLS + HEATMAP_MARGIN_COLS);
+
+    static Chunk chunks[CAP_HEATMAP_CHUNKS];
+    u32          len_chunks = 0;
+    for (i32 r = row_first < 0 ? 0 : row_first; (r < row_last) && (r < CHUNK_ROWS); ++r) {
+        for (i32 c = col_first < 0 ? 0 : col_first; (c < col_last) && (c < CHUNK_COLS); ++c) {
+            assert(len_chunks < CAP_HEATMAP_CHUNKS);
+            chunk_generate(&chunks[len_chunks++], (u32)c, (u32)r);
+        }
+    }
+
+    static Polygon polygons[CAP_HEATMAP_CHUNKS * CAP_CHUNK_OCCLUDERS];
+    u32            len_polygons = 0;
+    for (u32 i = 0; i < len_chunks; ++i) {
+        for (u32 j = 0; j < chunks[i].len_geoms; ++j) {
+            Polygon* polygon = &polygons[len_polygons++];
+            memcpy(&polygon->points[0], &chunks[i].quads[j].points[0], sizeof(Quad));
+            polygon->len_points = 4;
+        }
+        for (u32 j = 0; j < chunks[i].len_polygons; ++j) {
+            polygons[len_polygons++] = chunks[i].polygons[j];
+        }
+    }
+
+    Pool   pool;
+    Worker workers[CAP_THREADS];
+    pool_start(&pool, workers, CAP_THREADS);
+
+    Arena arenas[CAP_THREADS];
+    for (u32 i = 0; i < pool.len_threads; ++i) {
+        arenas[i] = (Arena){
+            .buffer = mmap(NULL,
+                           CAP_HEATMAP_ARENA,
+                           PROT_READ | PROT_WRITE,
+                           MAP_PRIVATE | MAP_ANONYMOUS,
+                           -1,
+                           0),
+            .cap = CAP_HEATMAP_ARENA,
+        };
+        assert(arenas[i].buffer != MAP_FAILED);
+    }
+
+    Heatmap heatmap = {
+        .polygons = polygons,
+        .len_polygons = len_polygons,
+        .origin = {(f32)(col * CHUNK_WIDTH), (f32)(row * CHUNK_HEIGHT)},
+        .cols = (HEATMAP_COLS * CHUNK_WIDTH) / HEATMAP_STEP,
+        .rows = (HEATMAP_ROWS * CHUNK_HEIGHT) / HEATMAP_STEP,
+        .stride = 1,
+        .arenas = arenas,
+    };
+    heatmap.areas = mmap(NULL,
+                         sizeof(f32) * heatmap.cols * heatmap.rows,
+                         PROT_READ | PROT_WRITE,
+                         MAP_PRIVATE | MAP_ANONYMOUS,
+                         -1,
+                         0);
+    assert(heatmap.areas != MAP_FAILED);
+
+    u64 start = now();
+    pool_run(&pool, heatmap_job, &heatmap);
+    const u64 elapsed = now() - start;
+
+    heatmap.next = 0;
+    heatmap.stride = HEATMAP_SAMPLE;
+    start = now();
+    heatmap_job(&heatmap, 0, 1);
+    const u64 elapsed_single = now() - start;
+
+    const u32 len_queries = heatmap.cols * heatmap.rows;
+    const u32 len_queries_single =
+        heatmap.cols * ((heatmap.rows + (HEATMAP_SAMPLE - 1)) / HEATMAP_SAMPLE);
+    const f64 queries_per_second = ((f64)len_queries * NANOS_PER_SECOND) / (f64)elapsed;
+    const f64 queries_per_second_single =
+        ((f64)len_queries_single * NANOS_PER_SECOND) / (f64)elapsed_single;
+
+    f32 sum = 0.0f;
+    for (u32 i = 0; i < len_queries; ++i) {
+        sum += heatmap.areas[i];
+    }
+
+    {
+        FILE* file = fopen(PATH_HEATMAP_IMAGE, "wb");
+        assert(file);
+        fprintf(file, "P6\n%u %u\n255\n", heatmap.cols, heatmap.rows);
+        for (u32 i = 0; i < len_queries; ++i) {
+            const f32 x = heatmap.areas[i] * 3.0f;
+            const u8  pixel[3] = {
+                (u8)(clamp(x, 0.0f, 1.0f) * 255.0f),
+                (u8)(clamp(x - 1.0f, 0.0f, 1.0f) * 255.0f),
+                (u8)(clamp(x - 2.0f, 0.0f, 1.0f) * 255.0f),
+            };
+            assert(fwrite(pixel, sizeof(pixel), 1, file) == 1);
+        }
+        assert(fclose(file) == 0);
+    }
+    {
+        FILE* file = fopen(PATH_HEATMAP_DATA, "wb");
+        assert(file);
+        assert(fwrite(heatmap.areas, sizeof(f32), len_queries, file) == len_queries);
+        assert(fclose(file) == 0);
+    }
+
+    printf("%9u x %u (%s, %s)\n"
+           "%9u queries\n"
+           "%9u occluders\n"
+           "%9.3f mean coverage\n"
+           "%9u threads\n"
+           "%9.0f queries/s\n"
+           "%9.0f queries/s on 1 thread\n"
+           "%9.2f x speedup\n"
+           "%9.2f per-core efficiency\n",
+           heatmap.cols,
+           heatmap.rows,
+           PATH_HEATMAP_IMAGE,
+           PATH_HEATMAP_DATA,
+           len_queries,
+           len_polygons,
+           (f64)(sum / (f32)len_queries),
+           pool.len_threads,
+           queries_per_second,
+           queries_per_second_single,
+           queries_per_second / queries_per_second_single,
+           (queries_per_second / queries_per_second_single) / pool.len_threads);
+
+    assert(munmap(heatmap.areas, sizeof(f32) * len_queries) == 0);
+    for (u32 i = 0; i < pool.len_threads; ++i) {
+        assert(munmap(arenas[i].buffer, CAP_HEATMAP_ARENA) == 0);
+    }
+    pool_stop(&pool, workers);
+    return 0;
+}
+
+// NOTE: `fan` is the angularly-sorted `points` of the current frame, all rays of which lie within
+// half a turn of one another around `origin` (the FOV guarantees this). Each query is a binary
+// search for the wedge of the fan containing it, followed by a single edge-side test against the
+// far edge of that wedge. The search runs in lock-step across a block of queries, with a trip count
+// that depends only on `len_fan`, so the inner loops stay branch-free and vectorize.
+static void query_visible(Vec2f        origin,
+                          const Vec2f* fan,
+                          u32          len_fan,
+                          const Vec2f* queries,
+                          Bool*        visible,
+                          u32          len_queries) {
+    if (len_fan < 2) {
+        for (u32 i = 0; i < len_queries; ++i) {
+            visible[i] = FALSE;
+        }
+        return;
+    }
+    for (u32 i = 0; i < len_queries; i += CAP_QUERIES_BLOCK) {
+        const u32 len_block =
+            (len_queries - i) < CAP_QUERIES_BLOCK ? (len_queries - i) : CAP_QUERIES_BLOCK;
+
+        u32 base[CAP_QUERIES_BLOCK] = {0};
+        for (u32 n = len_fan; 1 < n;) {
+            const u32 half = n / 2;
+            for (u32 j = 0; j < len_block; ++j) {
+                const u32 k = base[j] + half;
+                base[j] = cross(origin, fan[k], queries[i + j]) <= 0.0f ? k : base[j];
+            }
+            n -= half;
+        }
+
+        for (u32 j = 0; j < len_block; ++j) {
+            const Vec2f query = queries[i + j];
+            const u32   k = base[j] < (len_fan - 1) ? base[j] : len_fan - 2;
+            const f32   side = cross(fan[k], fan[k + 1], query) * cross(fan[k], fan[k + 1], origin);
+            visible[i + j] = ((cross(origin, fan[0], query) <= 0.0f) &&
+                              (0.0f <= cross(origin, fan[len_fan - 1], query)) && (0.0f <= side))
+                                 ? TRUE
+                                 : FALSE;
+        }
+    }
+}
+
+// NOTE: Any previous contents of the ring are reset, so consumers left over from an earlier run
+// see `head` go backwards and start over.
+static Ring* ring_open(void) {
+    const i32 file = shm_open(RING_NAME, O_CREAT | O_RDWR, 0644);
+    assert(0 <= file);
+    assert(ftruncate(file, sizeof(Ring)) == 0);
+
+    Ring* ring = mmap(NULL, sizeof(Ring), PROT_READ | PROT_WRITE, MAP_SHARED, file, 0);
+    close(file);
+    assert(ring != MAP_FAILED);
+
+    __atomic_store_n(&ring->magic, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&ring->head, 0, __ATOMIC_RELEASE);
+    for (u32 i = 0; i < CAP_RING_SLOTS; ++i) {
+        __atomic_store_n(&ring->slots[i].sequence, 0, __ATOMIC_RELEASE);
+    }
+    ring->version = RING_VERSION;
+    ring->cap_slots = CAP_RING_SLOTS;
+    ring->size_slot = sizeof(RingSlot);
+    __atomic_store_n(&ring->magic, RING_MAGIC, __ATOMIC_RELEASE);
+    return ring;
+}
+
+static void ring_publish(Ring*        ring,
+                         Vec2f        origin,
+                         Vec2f        look_to,
+                         const Vec2f* points,
+                         u32          len_points,
+                         const u32*   visible,
+                         u32          len_visible) {
+    assert(len_points <= CAP_RING_POINTS);
+    assert(len_visible <= CAP_RING_VISIBLE);
+
+    const u64 frame = ring->head + 1;
+    RingSlot* slot = &ring->slots[(frame - 1) % CAP_RING_SLOTS];
+
+    __atomic_store_n(&slot->sequence, (frame * 2) - 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+
+    slot->frame = frame;
+    slot->origin = (RingPoint){origin.x, origin.y};
+    slot->look_to = (RingPoint){look_to.x, look_to.y};
+    slot->len_points = len_points;
+    slot->len_visible = len_visible;
+    if (len_points != 0) {
+        memcpy(&slot->points[0], points, sizeof(Vec2f) * len_points);
+    }
+    if (len_visible != 0) {
+        memcpy(&slot->visible[0], visible, sizeof(u32) * len_visible);
+    }
+    slot->published_nanos = now();
+
+    __atomic_store_n(&slot->sequence, frame * 2, __ATOMIC_RELEASE);
+    __atomic_store_n(&ring->head, frame, __ATOMIC_RELEASE);
+}
+
+// NOTE: Returns `FALSE` if the GPU has not gotten through `sync` within `timeout` nanoseconds.
+static Bool fence_wait(GLsync sync, u64 timeout) {
+    const u32 status = glClientWaitSync(sync, GL_SYNC_FLUSH_COMMANDS_BIT, timeout);
+    assert(status != GL_WAIT_FAILED);
+    return ((status == GL_ALREADY_SIGNALED) || (status == GL_CONDITION_SATISFIED)) ? TRUE : FALSE;
+}
+
+// NOTE: Retires frames oldest-first for as long as their fences have signaled; if `block`, waits
+// for every one of them instead of stopping at the first still in flight.
+static void present_retire(Present* present, Bool block) {
+    while (present->len_fences != 0) {
+        Fence* fence = &present->fences[present->first];
+        if (!fence_wait(fence->sync, block ? FENCE_TIMEOUT_NANOS : 0)) {
+            return;
+        }
+        const u64 retired = now();
+        if (present->len_latencies < CAP_LATENCIES) {
+            present->latencies[present->len_latencies++] = retired - fence->sampled;
+        }
+        glDeleteSync(fence->sync);
+        present->first = (present->first + 1) % CAP_FENCES;
+        --present->len_fences;
+    }
+}
+
+// NOTE: Called right after `glfwSwapBuffers`; the fence signals once the GPU is done with every
+// command before it, the swap included.
+static void present_push(Present* present, u64 sampled) {
+    if (present->len_fences == CAP_FENCES) {
+        // NOTE: A slow GPU can take longer than `FENCE_TIMEOUT_NANOS` to get through a frame; that
+        // is no reason to give up on it, only to wait for it in more than one call.
+        const Fence* fence = &present->fences[present->first];
+        while (!fence_wait(fence->sync, FENCE_TIMEOUT_NANOS)) {
+        }
+        present_retire(present, FALSE);
+    }
+    present->fences[(present->first + present->len_fences) % CAP_FENCES] = (Fence){
+        glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0),
+        sampled,
+    };
+    ++present->len_fences;
+}
+
+// NOTE: Called once before reading any percentiles, which then only need to index.
+static void present_sort(Present* present) {
+    qsort(present->latencies, present->len_latencies, sizeof(present->latencies[0]), compare_u64);
+}
+
+static u64 present_percentile(const Present* present, u32 percent) {
+    if (present->len_latencies == 0) {
+        return 0;
+    }
+    return present->latencies[((present->len_latencies - 1) * percent) / 100];
+}
+
+// NOTE: Starts averaging over from scratch. Frames already in flight, as well as the one about to
+// be drawn, are not timed at what `level` now asks for, or are busy with (re)allocating the
+// targets, compiling shaders, and the like.
+static void governor_reset(Governor* governor) {
+    governor->gpu_sum = 0;
+    governor->cpu_sum = 0;
+    governor->len_gpu = 0;
+    governor->len_cpu = 0;
+    governor->len_discards = governor->len_timers + 1;
 }
 
-static Mat4 orthographic(f32 left, f32 right, f32 bottom, f32 top, f32 near, f32 far) {
-    return (Mat4){
-        .column_row[0][0] = 2.0f / (right - left),
-        .column_row[1][1] = 2.0f / (top - bottom),
-        .column_row[2][2] = 2.0f / (near - far),
-        .column_row[3][3] = 1.0f,
-        .column_row[3][0] = (left + right) / (left - right),
-        .column_row[3][1] = (bottom + top) / (bottom - top),
-        .column_row[3][2] = (near + far) / (near - far),
+// NOTE: Builds the governor's ladder of qualities, dropping steps that ask for more samples than
+// the driver supports, or that end up no different from the step before.
+static void governor_init(Governor* governor, i32 max_samples) {
+    const Quality qualities[] = {
+        {1.0f, MULTISAMPLES_TEXTURE},
+        {1.0f, 8},
+        {1.0f, 4},
+        {0.85f, 4},
+        {0.7f, 4},
+        {0.7f, 2},
+        {0.6f, 2},
+        {0.5f, 2},
+        {0.5f, 1},
     };
+    STATIC_ASSERT((sizeof(qualities) / sizeof(qualities[0])) <= CAP_QUALITIES);
+
+    *governor = (Governor){0};
+    glGenQueries(CAP_TIMERS, &governor->timers[0]);
+    for (u32 i = 0; i < (sizeof(qualities) / sizeof(qualities[0])); ++i) {
+        Quality quality = qualities[i];
+        if (max_samples < quality.samples) {
+            quality.samples = max_samples;
+        }
+        if (governor->len_qualities != 0) {
+            const Quality prev = governor->qualities[governor->len_qualities - 1];
+            if ((prev.samples == quality.samples) && !(quality.scale < prev.scale)) {
+                continue;
+            }
+        }
+        governor->qualities[governor->len_qualities++] = quality;
+    }
+    governor_reset(governor);
 }
 
-static void intersect(const Vec2f a[2], const Vec2f b[2], Vec2f* point) {
-    const f32 x0 = a[0].x - a[1].x;
-    const f32 y0 = a[0].y - a[1].y;
-
-    const f32 x1 = a[0].x - b[0].x;
-    const f32 y1 = a[0].y - b[0].y;
+// NOTE: Times the GPU from here until `governor_end`, unless every timer is still in flight.
+static void governor_begin(Governor* governor) {
+    governor->timing = governor->len_timers < CAP_TIMERS ? TRUE : FALSE;
+    if (governor->timing) {
+        glBeginQuery(GL_TIME_ELAPSED,
+                     governor->timers[(governor->first + governor->len_timers) % CAP_TIMERS]);
+    }
+}
 
-    const f32 x2 = b[0].x - b[1].x;
-    const f32 y2 = b[0].y - b[1].y;
+static void governor_end(Governor* governor) {
+    if (governor->timing) {
+        glEndQuery(GL_TIME_ELAPSED);
+        ++governor->len_timers;
+    }
+}
 
-    const f32 denominator = (x0 * y2) - (y0 * x2);
-    if (denominator == 0.0f) {
-        return;
+// NOTE: Collects whichever GPU timings have come back without waiting on the rest, adds `cpu` to
+// the CPU timings, and once enough frames are in, steps `level` against `budget`.
+static void governor_update(Governor* governor, u64 budget, u64 cpu) {
+    while (governor->len_timers != 0) {
+        const u32 timer = governor->timers[governor->first];
+        i32       available = FALSE;
+        glGetQueryObjectiv(timer, GL_QUERY_RESULT_AVAILABLE, &available);
+        if (!available) {
+            break;
+        }
+        u64 gpu = 0;
+        glGetQueryObjectui64v(timer, GL_QUERY_RESULT, &gpu);
+        if (governor->len_discards != 0) {
+            --governor->len_discards;
+        } else {
+            governor->gpu_sum += gpu;
+            ++governor->len_gpu;
+        }
+        governor->first = (governor->first + 1) % CAP_TIMERS;
+        --governor->len_timers;
     }
-    const f32 t = ((x1 * y2) - (y1 * x2)) / denominator;
-    const f32 u = -((x0 * y1) - (y0 * x1)) / denominator;
-    if ((t < 0.0f) || (1.0f < t) || (u < 0.0f) || (1.0f < u)) {
+    governor->cpu_sum += cpu;
+    ++governor->len_cpu;
+    if ((governor->len_cpu < GOVERNOR_FRAMES) || (governor->len_gpu == 0)) {
         return;
     }
-    point->x = a[0].x + (t * (a[1].x - a[0].x));
-    point->y = a[0].y + (t * (a[1].y - a[0].y));
+
+    governor->gpu_nanos = governor->gpu_sum / governor->len_gpu;
+    governor->cpu_nanos = governor->cpu_sum / governor->len_cpu;
+    governor->gpu_sum = 0;
+    governor->cpu_sum = 0;
+    governor->len_gpu = 0;
+    governor->len_cpu = 0;
+
+    // NOTE: Lowering quality only ever takes work off of the GPU, so a frame that is late on the
+    // CPU alone is left as is; it does, however, hold back raising quality again.
+    const f64 degrade = ((f64)budget) * (f64)GOVERNOR_DEGRADE;
+    const f64 restore = ((f64)budget) * (f64)GOVERNOR_RESTORE;
+    if ((degrade < (f64)governor->gpu_nanos) && ((governor->level + 1) < governor->len_qualities)) {
+        ++governor->level;
+    } else if (((f64)governor->gpu_nanos < restore) && ((f64)governor->cpu_nanos < restore) &&
+               (0 < governor->level))
+    {
+        --governor->level;
+    }
+}
+
+// NOTE: (Re)allocates every offscreen target; the framebuffers they are attached to pick up the new
+// storage on their own. Target `i` is left bound to texture unit `i`, which is where the shadow
+// composite samples the first two from. The last one, the static layer, gets `LAYER_MARGIN` extra
+// pixels on every side.
+static void targets_allocate(const u32* textures, i32 samples, i32 width, i32 height) {
+    for (u32 i = 0; i < CAP_TEXTURES; ++i) {
+        const i32 margin = (i == (CAP_TEXTURES - 1)) ? (LAYER_MARGIN * 2) : 0;
+        glActiveTexture(GL_TEXTURE0 + i);
+        glBindTexture(GL_TEXTURE_2D_MULTISAMPLE, textures[i]);
+        glTexImage2DMultisample(GL_TEXTURE_2D_MULTISAMPLE,
+                                samples,
+                                GL_RGBA8,
+                                width + margin,
+                                height + margin,
+                                FALSE);
+    }
+}
+
+// NOTE: Appends the static geoms of every loaded chunk within `extent` of `center` to `geoms`, and
+// the triangles of their polygons to `triangles` (each if given). Returns a signature of which
+// chunks those are, so a change in the set can be told apart without collecting anything. With
+// `len_triangles` but no `triangles`, only counts how many triangles there would be.
+static u32 layer_chunks(const Chunk* chunks,
+                        Vec2f        center,
+                        Vec2f        extent,
+                        Geom*        geoms,
+                        u32*         len_geoms,
+                        Triangle*    triangles,
+                        u32*         len_triangles) {
+    u32 signature = 0;
+    for (u32 i = 0; i < CAP_CHUNKS; ++i) {
+        if (!chunks[i].loaded) {
+            continue;
+        }
+        const f32 left = (f32)(chunks[i].col * CHUNK_WIDTH);
+        const f32 top = (f32)(chunks[i].row * CHUNK_HEIGHT);
+        if (((left + CHUNK_WIDTH) <= (center.x - extent.x)) || ((center.x + extent.x) <= left) ||
+            ((top + CHUNK_HEIGHT) <= (center.y - extent.y)) || ((center.y + extent.y) <= top))
+        {
+            continue;
+        }
+        signature = hash(signature ^ ((chunks[i].row * CHUNK_COLS) + chunks[i].col + 1));
+        for (u32 j = 0; geoms && (j < chunks[i].len_geoms); ++j) {
+            if (!chunks[i].spin[j]) {
+                geoms[(*len_geoms)++] = chunks[i].geoms[j];
+            }
+        }
+        for (u32 j = 0; len_triangles && (j < chunks[i].len_polygons); ++j) {
+            if (triangles) {
+                polygon_triangles(&chunks[i].polygons[j],
+                                  COLOR_OBJECT,
+                                  &triangles[*len_triangles]);
+            }
+            *len_triangles += chunks[i].polygons[j].len_points;
+        }
+    }
+    return signature;
 }
 
 __attribute__((noreturn)) static void callback_glfw_error(i32 code, const char* error) {
@@ -306,11 +2460,32 @@ static void callback_glfw_key(GLFWwindow* window, i32 key, i32, i32 action, i32)
         glfwSetWindowShouldClose(window, TRUE);
         break;
     }
+    case GLFW_KEY_TAB: {
+        Events* events = glfwGetWindowUserPointer(window);
+        events->shadow_map = events->shadow_map ? FALSE : TRUE;
+        break;
+    }
+    case GLFW_KEY_L: {
+        Events* events = glfwGetWindowUserPointer(window);
+        events->low_latency = events->low_latency ? FALSE : TRUE;
+        break;
+    }
+    case GLFW_KEY_V: {
+        Events* events = glfwGetWindowUserPointer(window);
+        ++events->pins;
+        break;
+    }
     default: {
     }
     }
 }
 
+static void callback_glfw_framebuffer_size(GLFWwindow* window, i32 width, i32 height) {
+    Events* events = glfwGetWindowUserPointer(window);
+    events->width = width;
+    events->height = height;
+}
+
 __attribute__((noreturn)) static void callback_gl_debug(u32         source,
                                                         u32         type,
                                                         u32         id,
@@ -342,7 +2517,7 @@ static void compile_shader(const char* path, u32 shader) {
     assert(address != MAP_FAILED);
 
     {
-#define CAP_BUFFER (1 << 11)
+#define CAP_BUFFER (1 << 12)
         assert(len <= CAP_BUFFER);
         char buffer[CAP_BUFFER];
         memcpy(buffer, address, len);
@@ -395,6 +2570,32 @@ static u32 compile_program(const char* source_vert, const char* source_frag) {
     return program;
 }
 
+// NOTE: Points the per-instance attributes of `program` at the geoms in the bound buffer, starting
+// from the one at index `first`; GL 3.3 has no `glDrawArraysInstancedBaseInstance`.
+static void geom_instances(u32 program, u32 first) {
+    const u64 offset = sizeof(Geom) * first;
+    SET_VERTEX_ATTRIB_DIV(program,
+                          "VERT_IN_TRANSLATE",
+                          2,
+                          sizeof(Geom),
+                          offset + offsetof(Geom, translate));
+    SET_VERTEX_ATTRIB_DIV(program,
+                          "VERT_IN_SCALE",
+                          2,
+                          sizeof(Geom),
+                          offset + offsetof(Geom, scale));
+    SET_VERTEX_ATTRIB_DIV(program,
+                          "VERT_IN_COLOR",
+                          4,
+                          sizeof(Geom),
+                          offset + offsetof(Geom, color));
+    SET_VERTEX_ATTRIB_DIV(program,
+                          "VERT_IN_ROTATE_RADIANS",
+                          1,
+                          sizeof(Geom),
+                          offset + offsetof(Geom, rotate_radians));
+}
+
 static void init_geom(u32          program,
                       u32          vao,
                       u32          vbo,
@@ -411,15 +2612,7 @@ static void init_geom(u32          program,
     BIND_BUFFER(vbo, vertices, size_vertices, GL_ARRAY_BUFFER, GL_STATIC_DRAW);
     SET_VERTEX_ATTRIB(program, "VERT_IN_POSITION", 2, sizeof(Vec2f), offsetof(Vec2f, x));
     BIND_BUFFER(instance_vbo, geoms, size_geoms, GL_ARRAY_BUFFER, GL_DYNAMIC_DRAW);
-
-    SET_VERTEX_ATTRIB_DIV(program, "VERT_IN_TRANSLATE", 2, sizeof(Geom), offsetof(Geom, translate));
-    SET_VERTEX_ATTRIB_DIV(program, "VERT_IN_SCALE", 2, sizeof(Geom), offsetof(Geom, scale));
-    SET_VERTEX_ATTRIB_DIV(program, "VERT_IN_COLOR", 4, sizeof(Geom), offsetof(Geom, color));
-    SET_VERTEX_ATTRIB_DIV(program,
-                          "VERT_IN_ROTATE_RADIANS",
-                          1,
-                          sizeof(Geom),
-                          offsetof(Geom, rotate_radians));
+    geom_instances(program, 0);
 
     glUniformMatrix4fv(glGetUniformLocation(program, "PROJECTION"),
                        1,
@@ -428,7 +2621,14 @@ static void init_geom(u32          program,
     glUniformMatrix4fv(glGetUniformLocation(program, "VIEW"), 1, FALSE, &view->column_row[0][0]);
 }
 
-i32 main(void) {
+i32 main(i32 len_args, const char** args) {
+    if ((len_args == 2) && (strcmp(args[1], "bench") == 0)) {
+        return bench();
+    }
+    if ((len_args == 2) && (strcmp(args[1], "heatmap") == 0)) {
+        return heatmap();
+    }
+
     glfwSetErrorCallback(callback_glfw_error);
 
     assert(glfwInit());
@@ -437,15 +2637,43 @@ i32 main(void) {
     glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
     glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
     glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
-    glfwWindowHint(GLFW_RESIZABLE, FALSE);
+    glfwWindowHint(GLFW_RESIZABLE, TRUE);
     glfwWindowHint(GLFW_SAMPLES, MULTISAMPLES_WINDOW);
     GLFWwindow* window = glfwCreateWindow(WINDOW_WIDTH, WINDOW_HEIGHT, __FILE__, NULL, NULL);
     assert(window);
 
+    // NOTE: `TAB` switches between the CPU corner-ray visibility and the GPU polar shadow map. `L`
+    // switches low-latency mode, which presents without waiting on vsync (tearing only when late,
+    // if the driver can), paces frames itself, and waits on the GPU at the end of every frame so
+    // that none ever queue up behind one another. `V` pins a copy of the player's view where it
+    // stands; the shadow map lights the scene from it along with the player.
+    Events events = {0};
+    glfwGetFramebufferSize(window, &events.width, &events.height);
+    glfwSetWindowUserPointer(window, &events);
+
     glfwSetKeyCallback(window, callback_glfw_key);
+    glfwSetFramebufferSizeCallback(window, callback_glfw_framebuffer_size);
     glfwMakeContextCurrent(window);
     glfwSwapInterval(1);
 
+    const i32 swap_interval_low_latency =
+        (glfwExtensionSupported("GLX_EXT_swap_control_tear") ||
+         glfwExtensionSupported("WGL_EXT_swap_control_tear"))
+            ? -1
+            : 0;
+    Bool low_latency = FALSE;
+
+    u64 nanos_per_frame = NANOS_PER_SECOND / 60;
+    {
+        const GLFWvidmode* mode = glfwGetVideoMode(glfwGetPrimaryMonitor());
+        if (mode && (0 < mode->refreshRate)) {
+            nanos_per_frame = NANOS_PER_SECOND / (u64)mode->refreshRate;
+        }
+    }
+    u64 deadline = 0;
+
+    Present present = {0};
+
     glEnable(GL_DEBUG_OUTPUT);
     glEnable(GL_DEBUG_OUTPUT_SYNCHRONOUS);
     glDebugMessageCallback(callback_gl_debug, NULL);
@@ -456,14 +2684,32 @@ i32 main(void) {
                           NULL,
                           FALSE);
 
-    glViewport(0, 0, WINDOW_WIDTH, WINDOW_HEIGHT);
+    // NOTE: Everything sized off of the window is redone whenever it changes size; see the top of
+    // the frame loop.
+    i32   width = events.width;
+    i32   height = events.height;
+    Vec2f screen = view_extent(width, height);
+
+    glViewport(0, 0, width, height);
     glClearColor(COLOR_BACKGROUND.x, COLOR_BACKGROUND.y, COLOR_BACKGROUND.z, COLOR_BACKGROUND.w);
     glEnable(GL_BLEND);
     glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
     glEnable(GL_MULTISAMPLE);
 
-    const Mat4 projection = orthographic(0, WINDOW_WIDTH, WINDOW_HEIGHT, 0, VIEW_NEAR, VIEW_FAR);
-    const Mat4 view = translate_rotate(VIEW_TRANSLATE, VIEW_ROTATE_RADIANS);
+    Mat4 projection = orthographic(0, screen.x, screen.y, 0, VIEW_NEAR, VIEW_FAR);
+
+    Vec2f position = {WORLD_WIDTH / 2.0f, WORLD_HEIGHT / 2.0f};
+    Vec2f speed = {0};
+    Vec2f camera = position;
+
+    Vec2f view_translate = camera_translate(camera, screen);
+    Mat4  view = translate_rotate(view_translate, VIEW_ROTATE_RADIANS);
+
+    // NOTE: The shadow pass composites in screen space, so its view stays where it would be if the
+    // camera never moved.
+    Mat4 view_screen = translate_rotate(
+        camera_translate((Vec2f){screen.x / 2.0f, screen.y / 2.0f}, screen),
+        VIEW_ROTATE_RADIANS);
 
     u32 vao[CAP_VAO];
     glGenVertexArrays(CAP_VAO, &vao[0]);
@@ -476,11 +2722,11 @@ i32 main(void) {
 
     const Vec2f vertices_line[] = {{0.0f, 0.0f}, {1.0f, 1.0f}};
 
-    Geom lines[CAP_LINES] = {
-        {{0}, {WINDOW_WIDTH, 0.0f}, COLOR_LINE_0, 0.0f},
-        {{WINDOW_WIDTH, 0.0f}, {0.0f, WINDOW_HEIGHT}, COLOR_LINE_0, 0.0f},
-        {{WINDOW_WIDTH, WINDOW_HEIGHT}, {-WINDOW_WIDTH, 0.0f}, COLOR_LINE_0, 0.0f},
-        {{0.0f, WINDOW_HEIGHT}, {0.0f, -WINDOW_HEIGHT}, COLOR_LINE_0, 0.0f},
+    const Geom border[4] = {
+        {{0}, {WORLD_WIDTH, 0.0f}, COLOR_LINE_0, 0.0f},
+        {{WORLD_WIDTH, 0.0f}, {0.0f, WORLD_HEIGHT}, COLOR_LINE_0, 0.0f},
+        {{WORLD_WIDTH, WORLD_HEIGHT}, {-WORLD_WIDTH, 0.0f}, COLOR_LINE_0, 0.0f},
+        {{0.0f, WORLD_HEIGHT}, {0.0f, -WORLD_HEIGHT}, COLOR_LINE_0, 0.0f},
     };
 
     const u32 program_line = compile_program(PATH_GEOM_VERT, PATH_GEOM_FRAG);
@@ -490,8 +2736,8 @@ i32 main(void) {
               instance_vbo[0],
               vertices_line,
               sizeof(vertices_line),
-              lines,
-              sizeof(lines),
+              border,
+              sizeof(border),
               &projection,
               &view);
     glLineWidth(LINE_WIDTH);
@@ -505,15 +2751,11 @@ i32 main(void) {
     };
 
     Geom quads[CAP_QUADS] = {
-        {{0}, {WINDOW_WIDTH, WINDOW_HEIGHT}, COLOR_WORLD, 0.0f},
-        {{400.0f, 400.0f}, {25.0f, 100.0f}, COLOR_OBJECT, 0.0f},
-        {{600.0f, 250.0f}, {10.0f, 150.0f}, COLOR_OBJECT, 0.0f},
-        {{850.0f, 400.0f}, {5.0f, 300.0f}, COLOR_OBJECT, 0.0f},
-        {{850.0f, 300.0f}, {100.0f, 5.0f}, COLOR_OBJECT, 0.0f},
-        {{1200.0f, 150.0f}, {5.0f, 50.0f}, COLOR_OBJECT, 0.0f},
-        {{1150.0f, 225.0f}, {25.0f, 25.0f}, COLOR_OBJECT, 0.0f},
-        {{1175.0f, 650.0f}, {5.0f, 75.0f}, COLOR_OBJECT, 0.0f},
+        {{0}, {WORLD_WIDTH, WORLD_HEIGHT}, COLOR_WORLD, 0.0f},
     };
+    u32 ids[CAP_QUADS] = {0};
+
+    Chunk chunks[CAP_CHUNKS] = {0};
 
     const u32 program_quad = compile_program(PATH_GEOM_VERT, PATH_GEOM_FRAG);
     init_geom(program_quad,
@@ -527,13 +2769,14 @@ i32 main(void) {
               &projection,
               &view);
 
-    Triangle triangles[CAP_TRIANGLES];
+    const i32 uniform_quad_projection = glGetUniformLocation(program_quad, "PROJECTION");
+    const i32 uniform_quad_view = glGetUniformLocation(program_quad, "VIEW");
 
     const u32 program_triangles = compile_program(PATH_TRIANGLE_VERT, PATH_TRIANGLE_FRAG);
     glUseProgram(program_triangles);
     glBindVertexArray(vao[2]);
 
-    BIND_BUFFER(vbo[2], triangles, sizeof(triangles), GL_ARRAY_BUFFER, GL_DYNAMIC_DRAW);
+    BIND_BUFFER(vbo[2], NULL, 0, GL_ARRAY_BUFFER, GL_DYNAMIC_DRAW);
 
     SET_VERTEX_ATTRIB(program_triangles,
                       "VERT_IN_POSITION",
@@ -546,15 +2789,24 @@ i32 main(void) {
                        1,
                        FALSE,
                        &projection.column_row[0][0]);
-    glUniformMatrix4fv(glGetUniformLocation(program_triangles, "VIEW"),
-                       1,
-                       FALSE,
-                       &view.column_row[0][0]);
+    const i32 uniform_triangles_projection = glGetUniformLocation(program_triangles, "PROJECTION");
+    const i32 uniform_triangles_view = glGetUniformLocation(program_triangles, "VIEW");
+    glUniformMatrix4fv(uniform_triangles_view, 1, FALSE, &view.column_row[0][0]);
+
+    // NOTE: Chunk polygons, drawn as triangles into the static layer only.
+    glBindVertexArray(vao[6]);
+    BIND_BUFFER(vbo[5], NULL, 0, GL_ARRAY_BUFFER, GL_DYNAMIC_DRAW);
+    SET_VERTEX_ATTRIB(program_triangles,
+                      "VERT_IN_POSITION",
+                      2,
+                      sizeof(Point),
+                      offsetof(Point, translate));
+    SET_VERTEX_ATTRIB(program_triangles, "VERT_IN_COLOR", 4, sizeof(Point), offsetof(Point, color));
 
-    const Vec2f shadow[] = {
-        {WINDOW_WIDTH, WINDOW_HEIGHT},
-        {WINDOW_WIDTH, 0.0f},
-        {0.0f, WINDOW_HEIGHT},
+    Vec2f shadow[] = {
+        {screen.x, screen.y},
+        {screen.x, 0.0f},
+        {0.0f, screen.y},
         {0.0f, 0.0f},
     };
 #define LEN_SHADOWS (sizeof(shadow) / sizeof(shadow[0]))
@@ -568,22 +2820,28 @@ i32 main(void) {
                        1,
                        FALSE,
                        &projection.column_row[0][0]);
-    glUniformMatrix4fv(glGetUniformLocation(program_shadow, "VIEW"),
-                       1,
-                       FALSE,
-                       &view.column_row[0][0]);
+    const i32 uniform_shadow_view = glGetUniformLocation(program_shadow, "VIEW");
+    glUniformMatrix4fv(uniform_shadow_view, 1, FALSE, &view_screen.column_row[0][0]);
+
+    // NOTE: Software rasterizers (e.g. Mesa's `llvmpipe`) cap out at fewer samples than we ask for.
+    i32 multisamples = 0;
+    glGetIntegerv(GL_MAX_COLOR_TEXTURE_SAMPLES, &multisamples);
+    if (MULTISAMPLES_TEXTURE < multisamples) {
+        multisamples = MULTISAMPLES_TEXTURE;
+    }
+
+    // NOTE: The offscreen targets start out at full scale and sample count; the governor trades
+    // either away for frame time as it sees fit, and the shadow pass scales back up to the window.
+    Governor governor;
+    governor_init(&governor, multisamples);
+
+    i32 render_width = width;
+    i32 render_height = height;
+    i32 render_samples = governor.qualities[0].samples;
 
     u32 textures[CAP_TEXTURES];
     glGenTextures(CAP_TEXTURES, &textures[0]);
-    for (u32 i = 0; i < CAP_TEXTURES; ++i) {
-        glBindTexture(GL_TEXTURE_2D_MULTISAMPLE, textures[i]);
-        glTexImage2DMultisample(GL_TEXTURE_2D_MULTISAMPLE,
-                                MULTISAMPLES_TEXTURE,
-                                GL_RGBA8,
-                                WINDOW_WIDTH,
-                                WINDOW_HEIGHT,
-                                FALSE);
-    }
+    targets_allocate(&textures[0], render_samples, render_width, render_height);
 
     u32 fbo[CAP_FBO];
     glGenFramebuffers(CAP_FBO, &fbo[0]);
@@ -598,19 +2856,121 @@ i32 main(void) {
 
     assert(glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE);
 
-    glActiveTexture(GL_TEXTURE0);
-    glBindTexture(GL_TEXTURE_2D_MULTISAMPLE, textures[0]);
     glUniform1i(glGetUniformLocation(program_shadow, "TEXTURE"), 0);
-
-    glActiveTexture(GL_TEXTURE1);
-    glBindTexture(GL_TEXTURE_2D_MULTISAMPLE, textures[1]);
     glUniform1i(glGetUniformLocation(program_shadow, "MASK"), 1);
 
     const i32 uniform_blend = glGetUniformLocation(program_shadow, "BLEND");
-    glUniform1i(glGetUniformLocation(program_shadow, "MULTISAMPLES_SHADOW"), MULTISAMPLES_SHADOW);
+    const i32 uniform_multisamples_shadow =
+        glGetUniformLocation(program_shadow, "MULTISAMPLES_SHADOW");
+    const i32 uniform_upscale = glGetUniformLocation(program_shadow, "UPSCALE");
+    glUniform1i(uniform_multisamples_shadow,
+                MULTISAMPLES_SHADOW < render_samples ? MULTISAMPLES_SHADOW : render_samples);
+    glUniform1i(uniform_upscale, FALSE);
+
+    const u32 program_polar = compile_program(PATH_POLAR_VERT, PATH_POLAR_FRAG);
+    glUseProgram(program_polar);
+    glBindVertexArray(vao[4]);
+    BIND_BUFFER(instance_vbo[3], NULL, 0, GL_ARRAY_BUFFER, GL_DYNAMIC_DRAW);
+    SET_VERTEX_ATTRIB_DIV(program_polar, "VERT_IN_EDGE", 4, sizeof(Vec4f), 0);
+
+    glUniform1i(glGetUniformLocation(program_polar, "ROWS"), CAP_VIEWERS);
+    glUniform1i(glGetUniformLocation(program_polar, "BINS"), POLAR_BINS);
+    glUniform1f(glGetUniformLocation(program_polar, "DISTANCE"), WINDOW_DIAGONAL);
+    const i32 uniform_polar_viewers = glGetUniformLocation(program_polar, "VIEWERS");
+
+    u32 polar_texture;
+    glGenTextures(1, &polar_texture);
+    glActiveTexture(GL_TEXTURE2);
+    glBindTexture(GL_TEXTURE_2D, polar_texture);
+    glTexImage2D(GL_TEXTURE_2D,
+                 0,
+                 GL_DEPTH_COMPONENT32F,
+                 POLAR_BINS,
+                 CAP_VIEWERS,
+                 0,
+                 GL_DEPTH_COMPONENT,
+                 GL_FLOAT,
+                 NULL);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+
+    u32 polar_fbo;
+    glGenFramebuffers(1, &polar_fbo);
+    glBindFramebuffer(GL_FRAMEBUFFER, polar_fbo);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, polar_texture, 0);
+    glDrawBuffer(GL_NONE);
+    glReadBuffer(GL_NONE);
 
-    Vec2f position = {WINDOW_WIDTH / 2.0f, WINDOW_HEIGHT / 2.0f};
-    Vec2f speed = {0};
+    assert(glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE);
+
+    const u32 program_mask = compile_program(PATH_MASK_VERT, PATH_MASK_FRAG);
+    glUseProgram(program_mask);
+    glBindVertexArray(vao[5]);
+    BIND_BUFFER(vbo[4], NULL, sizeof(Vec2f) * 4, GL_ARRAY_BUFFER, GL_DYNAMIC_DRAW);
+    SET_VERTEX_ATTRIB(program_mask, "VERT_IN_POSITION", 2, sizeof(Vec2f), offsetof(Vec2f, x));
+    glUniformMatrix4fv(glGetUniformLocation(program_mask, "PROJECTION"),
+                       1,
+                       FALSE,
+                       &projection.column_row[0][0]);
+    glUniform1i(glGetUniformLocation(program_mask, "POLAR"), 2);
+    glUniform1f(glGetUniformLocation(program_mask, "DISTANCE"), WINDOW_DIAGONAL);
+    glUniform4f(glGetUniformLocation(program_mask, "COLOR"),
+                COLOR_TRIANGLE_0.x,
+                COLOR_TRIANGLE_0.y,
+                COLOR_TRIANGLE_0.z,
+                COLOR_TRIANGLE_0.w);
+
+    const i32 uniform_mask_view = glGetUniformLocation(program_mask, "VIEW");
+    const i32 uniform_mask_viewers = glGetUniformLocation(program_mask, "VIEWERS");
+    const i32 uniform_mask_len_viewers = glGetUniformLocation(program_mask, "LEN_VIEWERS");
+
+    // NOTE: Every viewer is `(x, y, look radians, half fov)`. The player's goes first, then those
+    // pinned with `V`; once all `CAP_VIEWERS - 1` pins are taken, the oldest gets replaced.
+    Vec4f viewers[CAP_VIEWERS];
+    Vec4f pinned[CAP_VIEWERS - 1];
+    u32   pins = 0;
+
+    // NOTE: Every frame's visibility gets published here for out-of-process consumers; see
+    // `src/ring.h` for the layout and `src/reader.c` for a consumer.
+    Ring* ring = ring_open();
+
+    Pool   pool;
+    Worker workers[CAP_THREADS_RENDER];
+    pool_start(&pool, workers, CAP_THREADS_RENDER);
+    pool_calibrate(&pool, &border[0]);
+    {
+        const char* pairs_min = getenv(ENV_PAIRS_MIN);
+        if (pairs_min) {
+            char* end = NULL;
+            pool.pairs_min = strtoull(pairs_min, &end, 10);
+            assert((end != pairs_min) && (*end == '\0'));
+        }
+    }
+
+    Store store;
+    store_open(&store);
+
+    // NOTE: Whatever is around the camera to begin with gets loaded up front, so the first frames
+    // are not drawn over an empty world.
+    Loader loader;
+    loader_start(&loader);
+    chunks_stream(chunks,
+                  (u32)(camera.x / CHUNK_WIDTH),
+                  (u32)(camera.y / CHUNK_HEIGHT),
+                  chunks_radius(screen));
+
+    Arena arena = {.cap = CAP_ARENA};
+    {
+        const char* cap = getenv(ENV_ARENA);
+        if (cap) {
+            char* end = NULL;
+            arena.cap = strtoull(cap, &end, 10);
+            assert((end != cap) && (*end == '\0') && (arena.cap != 0));
+        }
+    }
+    arena.buffer =
+        mmap(NULL, arena.cap, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    assert(arena.buffer != MAP_FAILED);
 
     u64 prev = now();
     u64 elapsed = 0;
@@ -620,8 +2980,22 @@ i32 main(void) {
     u32 len_quads = 0;
     u32 len_points = 0;
     u32 len_triangles = 0;
-
-    printf("\n\n\n\n\n\n");
+    u32 len_visible = 0;
+    u32 len_chunks = 0;
+    u32 len_loads = 0;
+    u32 len_edges = 0;
+    u32 len_vertices = 0;
+    u32 len_threads = 0;
+    u32 len_redraws = 0;
+
+    Geom  layer[1 + (CAP_CHUNKS * CAP_CHUNK_GEOMS)];
+    Bool  cached = FALSE;
+    Vec2f cached_center = {0};
+    i32   cached_x = 0;
+    i32   cached_y = 0;
+    u32   cached_signature = 0;
+
+    printf("\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n");
     while (!glfwWindowShouldClose(window)) {
         {
             const u64 next = now();
@@ -629,28 +3003,166 @@ i32 main(void) {
             prev = next;
             if (NANOS_PER_SECOND <= elapsed) {
                 const f64 nanoseconds_per_frame = ((f64)elapsed) / ((f64)frames);
-                printf("\033[6A"
+                present_sort(&present);
+                // NOTE: Casts never get split on a single core, or when splitting saves nothing.
+#define CAP_BUFFER (1 << 5)
+                char pairs_min[CAP_BUFFER] = "off";
+                if (pool.pairs_min != UINT64_MAX) {
+                    snprintf(pairs_min, CAP_BUFFER, "%lu", pool.pairs_min);
+                }
+#undef CAP_BUFFER
+                printf("\033[23A"
                        "%9.0f ns/f\n"
                        "%9lu frames\n"
                        "%9u len_lines\n"
                        "%9u len_quads\n"
                        "%9u len_points\n"
-                       "%9u len_triangles\n",
+                       "%9u len_triangles\n"
+                       "%9u len_visible\n"
+                       "%9u len_chunks\n"
+                       "%9u len_loads\n"
+                       "%9u len_edges\n"
+                       "%9u len_vertices\n"
+                       "%9u len_threads\n"
+                       "%9s pairs_min\n"
+                       "%9u len_redraws\n"
+                       "%9lu arena_high_water\n"
+                       "%9lu arena_overflows\n"
+                       "%9.0f us latency p50\n"
+                       "%9.0f us latency p99\n"
+                       "%9.0f us latency max\n"
+                       "%9.0f us cpu\n"
+                       "%9.0f us gpu\n"
+                       "%9.2f render_scale\n"
+                       "%9d render_samples\n",
                        nanoseconds_per_frame,
                        frames,
                        len_lines,
                        len_quads,
                        len_points,
-                       len_triangles);
+                       len_triangles,
+                       len_visible,
+                       len_chunks,
+                       len_loads,
+                       len_edges,
+                       len_vertices,
+                       len_threads,
+                       pairs_min,
+                       len_redraws,
+                       arena.high_water,
+                       arena.overflows,
+                       ((f64)present_percentile(&present, 50)) / 1000.0,
+                       ((f64)present_percentile(&present, 99)) / 1000.0,
+                       ((f64)present_percentile(&present, 100)) / 1000.0,
+                       ((f64)governor.cpu_nanos) / 1000.0,
+                       ((f64)governor.gpu_nanos) / 1000.0,
+                       (f64)governor.qualities[governor.level].scale,
+                       render_samples);
                 elapsed = 0;
                 frames = 0;
+                len_loads = 0;
+                len_redraws = 0;
+                arena.high_water = 0;
+                arena.overflows = 0;
+                present.len_latencies = 0;
             }
         }
 
         ++frames;
 
+        arena.len = 0;
+
+        if (low_latency != events.low_latency) {
+            low_latency = events.low_latency;
+            glfwSwapInterval(low_latency ? swap_interval_low_latency : 1);
+            deadline = now();
+        }
+        // NOTE: Without vsync to hold frames back, sleep off whatever is left of this frame's slot
+        // *before* input is read, rather than after the frame is drawn.
+        if (low_latency) {
+            deadline += nanos_per_frame;
+            const u64 start = now();
+            if (start < deadline) {
+                const u64  nanos = deadline - start;
+                const Time time = {
+                    (i64)(nanos / NANOS_PER_SECOND),
+                    (i64)(nanos % NANOS_PER_SECOND),
+                };
+                nanosleep(&time, NULL);
+            } else {
+                deadline = start;
+            }
+        }
+
         glfwPollEvents();
 
+        // NOTE: A minimized window has nothing to draw into.
+        if ((events.width == 0) || (events.height == 0)) {
+            glfwWaitEvents();
+            continue;
+        }
+
+        const u64 begun = now();
+
+        if ((width != events.width) || (height != events.height)) {
+            width = events.width;
+            height = events.height;
+            screen = view_extent(width, height);
+
+            projection = orthographic(0, screen.x, screen.y, 0, VIEW_NEAR, VIEW_FAR);
+            const u32 programs[] = {
+                program_line,
+                program_quad,
+                program_triangles,
+                program_shadow,
+                program_mask,
+            };
+            for (u32 i = 0; i < (sizeof(programs) / sizeof(programs[0])); ++i) {
+                glUseProgram(programs[i]);
+                glUniformMatrix4fv(glGetUniformLocation(programs[i], "PROJECTION"),
+                                   1,
+                                   FALSE,
+                                   &projection.column_row[0][0]);
+            }
+
+            view_screen = translate_rotate(
+                camera_translate((Vec2f){screen.x / 2.0f, screen.y / 2.0f}, screen),
+                VIEW_ROTATE_RADIANS);
+            glUseProgram(program_shadow);
+            glUniformMatrix4fv(uniform_shadow_view, 1, FALSE, &view_screen.column_row[0][0]);
+
+            shadow[0] = (Vec2f){screen.x, screen.y};
+            shadow[1] = (Vec2f){screen.x, 0.0f};
+            shadow[2] = (Vec2f){0.0f, screen.y};
+            glBindBuffer(GL_ARRAY_BUFFER, vbo[3]);
+            glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(shadow), &shadow[0]);
+        }
+
+        // NOTE: Offscreen targets follow both the window's size and the governor's latest pick.
+        // Reallocating them throws out whatever the static layer had cached.
+        {
+            const Quality quality = governor.qualities[governor.level];
+            const i32     quality_width = (i32)ceilf((f32)width * quality.scale);
+            const i32     quality_height = (i32)ceilf((f32)height * quality.scale);
+            if ((render_width != quality_width) || (render_height != quality_height) ||
+                (render_samples != quality.samples))
+            {
+                render_width = quality_width;
+                render_height = quality_height;
+                render_samples = quality.samples;
+                targets_allocate(&textures[0], render_samples, render_width, render_height);
+                cached = FALSE;
+                governor_reset(&governor);
+
+                glUseProgram(program_shadow);
+                glUniform1i(uniform_multisamples_shadow,
+                            MULTISAMPLES_SHADOW < render_samples ? MULTISAMPLES_SHADOW
+                                                                 : render_samples);
+                glUniform1i(uniform_upscale,
+                            ((render_width < width) || (render_height < height)) ? TRUE : FALSE);
+            }
+        }
+
         Vec2f move = {0};
         if (glfwGetKey(window, GLFW_KEY_W) == GLFW_PRESS) {
             move.y -= 1.0f;
@@ -674,28 +3186,121 @@ i32 main(void) {
         speed.x *= FRICTION;
         speed.y *= FRICTION;
 #undef FRICTION
-        position.x += speed.x;
-        position.y += speed.y;
+        position.x = clamp(position.x + speed.x, 0.0f, WORLD_WIDTH);
+        position.y = clamp(position.y + speed.y, 0.0f, WORLD_HEIGHT);
+
+        camera.x += (position.x - camera.x) * CAMERA_FOLLOW;
+        camera.y += (position.y - camera.y) * CAMERA_FOLLOW;
+        camera.x = clamp(camera.x, screen.x / 2.0f, WORLD_WIDTH - (screen.x / 2.0f));
+        camera.y = clamp(camera.y, screen.y / 2.0f, WORLD_HEIGHT - (screen.y / 2.0f));
+
+        // NOTE: The view is snapped to whole render pixels, so the cached static layer can be
+        // copied over at an integer offset and still line up with everything drawn on top of it.
+        const Vec2f render_scale = {(f32)render_width / screen.x, (f32)render_height / screen.y};
+        view_translate = camera_translate(camera, screen);
+        const i32 translate_x = (i32)roundf(view_translate.x * render_scale.x);
+        const i32 translate_y = (i32)roundf(view_translate.y * render_scale.y);
+        view_translate.x = (f32)translate_x / render_scale.x;
+        view_translate.y = (f32)translate_y / render_scale.y;
+        view = translate_rotate(view_translate, VIEW_ROTATE_RADIANS);
+
+        len_loads += loader_stream(&loader,
+                                   chunks,
+                                   (u32)(camera.x / CHUNK_WIDTH),
+                                   (u32)(camera.y / CHUNK_HEIGHT),
+                                   chunks_radius(screen));
+
+        // NOTE: Only chunks overlapping the window are touched by visibility and rendering. This
+        // assumes `VIEW_ROTATE_RADIANS` is a multiple of a half turn, so the window's extents in
+        // the world are its own. Static geoms go first, so together with the world they make up
+        // `quads[0, len_static)`; everything after is drawn over the cached static layer.
+        len_quads = 1;
+        len_chunks = 0;
+        u32 len_polygon_points = 0;
+        for (u32 i = 0; i < CAP_CHUNKS; ++i) {
+            chunks[i].touched = FALSE;
+            if (!chunks[i].loaded) {
+                continue;
+            }
+            const f32 left = (f32)(chunks[i].col * CHUNK_WIDTH);
+            const f32 top = (f32)(chunks[i].row * CHUNK_HEIGHT);
+            if (((left + CHUNK_WIDTH) <= (camera.x - (screen.x / 2.0f))) ||
+                ((camera.x + (screen.x / 2.0f)) <= left) ||
+                ((top + CHUNK_HEIGHT) <= (camera.y - (screen.y / 2.0f))) ||
+                ((camera.y + (screen.y / 2.0f)) <= top))
+            {
+                continue;
+            }
+            ++len_chunks;
+            chunks[i].touched = TRUE;
+            for (u32 j = 0; j < chunks[i].len_polygons; ++j) {
+                len_polygon_points += chunks[i].polygons[j].len_points;
+            }
+            for (u32 j = 0; j < chunks[i].len_geoms; ++j) {
+                if (chunks[i].spin[j]) {
+                    chunks[i].geoms[j].rotate_radians += 0.001f;
+                    if (TAU <= chunks[i].geoms[j].rotate_radians) {
+                        chunks[i].geoms[j].rotate_radians -= TAU;
+                    }
+                    continue;
+                }
+                assert(len_quads < CAP_QUADS);
+                ids[len_quads] = geom_id(&chunks[i], j);
+                quads[len_quads++] = chunks[i].geoms[j];
+            }
+        }
+        const u32 len_static = len_quads;
+        for (u32 i = 0; i < CAP_CHUNKS; ++i) {
+            if (!chunks[i].touched) {
+                continue;
+            }
+            for (u32 j = 0; j < chunks[i].len_geoms; ++j) {
+                if (!chunks[i].spin[j]) {
+                    continue;
+                }
+                assert(len_quads < CAP_QUADS);
+                ids[len_quads] = geom_id(&chunks[i], j);
+                quads[len_quads++] = chunks[i].geoms[j];
+            }
+        }
+        store_update(&store, chunks);
 
+        // NOTE: Everything the cursor drives happens from here on, so it gets sampled as late as it
+        // can be; in low-latency mode, events are pumped once more right before.
+        if (events.low_latency) {
+            glfwPollEvents();
+        }
+        const u64 sampled = now();
         Vec2d cursor;
         glfwGetCursorPos(window, &cursor.x, &cursor.y);
 
-        Vec2f look_to = (Vec2f){(f32)cursor.x, (f32)cursor.y};
-        look_to.x -= VIEW_TRANSLATE.x;
-        look_to.y -= VIEW_TRANSLATE.y;
+        // NOTE: The cursor is in window coordinates, which need not be pixels, let alone the view's
+        // units once it is zoomed in; see `view_extent`.
+        i32 window_width;
+        i32 window_height;
+        glfwGetWindowSize(window, &window_width, &window_height);
+        Vec2f look_to = (Vec2f){
+            (f32)cursor.x * (screen.x / (f32)(window_width < 1 ? 1 : window_width)),
+            (f32)cursor.y * (screen.y / (f32)(window_height < 1 ? 1 : window_height)),
+        };
+        look_to.x -= view_translate.x;
+        look_to.y -= view_translate.y;
         look_to = turn((Vec2f){0}, look_to, VIEW_ROTATE_RADIANS);
 
 #define LOOK_FROM_OFFSET 15.0f
         const Vec2f look_from = extend(position, look_to, LOOK_FROM_OFFSET);
 #undef LOOK_FROM_OFFSET
 
-        len_quads = 8;
-        for (u32 i = 1; i < len_quads; ++i) {
-            quads[i].rotate_radians += 0.001f;
-            if (TAU <= quads[i].rotate_radians) {
-                quads[i].rotate_radians -= TAU;
-            }
+        const Vec4f viewer_player = {
+            look_from.x,
+            look_from.y,
+            atan2f(look_to.y - look_from.y, look_to.x - look_from.x),
+            FOV_RADIANS / 2.0f,
+        };
+        for (; pins != events.pins; ++pins) {
+            pinned[pins % (CAP_VIEWERS - 1)] = viewer_player;
         }
+
         {
 #define PLAYER_WIDTH  24.0f
 #define PLAYER_HEIGHT 16.0f
@@ -717,12 +3322,42 @@ i32 main(void) {
 #undef PLAYER_HEIGHT
         }
 
-        Quad rotated_quads[CAP_QUADS];
-        for (u32 i = 0; i < len_quads; ++i) {
+        // NOTE: Where a shot from the player towards the cursor would land, marked by a quad kept
+        // just past `quads[len_quads - 1]`, so it is drawn along with the rest but takes no part in
+        // visibility.
+        u32 len_markers = 0;
+        {
+            const Ray ray = {
+                look_from,
+                {look_to.x - look_from.x, look_to.y - look_from.y},
+                WINDOW_DIAGONAL,
+            };
+            Hit hit;
+            raycast(&store.occluders, &ray, &hit, 1);
+            if (hit.id != ID_NONE) {
+#define MARKER_SIZE 6.0f
+                const Vec2f direction = normalize(ray.direction);
+                assert(len_quads < CAP_QUADS);
+                quads[len_quads] = (Geom){
+                    {
+                        look_from.x + (direction.x * hit.distance) - (MARKER_SIZE / 2.0f),
+                        look_from.y + (direction.y * hit.distance) - (MARKER_SIZE / 2.0f),
+                    },
+                    {MARKER_SIZE, MARKER_SIZE},
+                    COLOR_MARKER,
+                    0.0f,
+                };
+                len_markers = 1;
+#undef MARKER_SIZE
+            }
+        }
+
+        Quad* rotated_quads = arena_alloc(&arena, sizeof(Quad) * len_quads);
+        for (u32 i = 0; rotated_quads && (i < len_quads); ++i) {
             rotated_quads[i] = geom_to_quad(quads[i]);
         }
 
-        f32 blend = look_from.x / WINDOW_WIDTH;
+        f32 blend = (look_from.x - (camera.x - (screen.x / 2.0f))) / screen.x;
         if (blend < 0.0f) {
             blend = 0.0f;
         }
@@ -730,20 +3365,31 @@ i32 main(void) {
             blend = 1.0f;
         }
 
-#define FOV_RADIANS ((70.0f * PI) / 180.0f)
         Vec2f target[2] = {
             extend(look_from, turn(look_from, look_to, -(FOV_RADIANS / 2.0f)), WINDOW_DIAGONAL),
             extend(look_from, turn(look_from, look_to, FOV_RADIANS / 2.0f), WINDOW_DIAGONAL),
         };
-#undef FOV_RADIANS
 
-        len_lines = 6;
-        assert(len_lines <= CAP_LINES);
-        lines[4].translate = target[0];
-        lines[5].translate = target[1];
-        for (u32 i = 4; i < 6; ++i) {
-            lines[i].scale.x = look_from.x - lines[i].translate.x;
-            lines[i].scale.y = look_from.y - lines[i].translate.y;
+        // NOTE: Every corner of every geom and polygon in view, the player's included.
+        const u32 cap_vertices = (len_quads * 4) + len_polygon_points;
+
+        // NOTE: The world's border, the two edges of the field of view, and at most one line per
+        // occluder vertex.
+        const u32 cap_lines = 4 + 2 + cap_vertices;
+        Geom*     lines = arena_alloc(&arena, sizeof(Geom) * cap_lines);
+
+        len_lines = 0;
+        if (lines) {
+            memcpy(&lines[0], &border[0], sizeof(border));
+            for (u32 i = 0; i < 2; ++i) {
+                lines[4 + i] = (Geom){
+                    target[i],
+                    {look_from.x - target[i].x, look_from.y - target[i].y},
+                    COLOR_LINE_0,
+                    0.0f,
+                };
+            }
+            len_lines = 6;
         }
 
         f32 fov[2] = {
@@ -788,7 +3434,7 @@ i32 main(void) {
         if (!inside) {                                                                           \
             break;                                                                               \
         }                                                                                        \
-        assert(len_lines < CAP_LINES);                                                           \
+        assert(len_lines < cap_lines);                                                           \
         lines[len_lines++] = (Geom){                                                             \
             (point),                                                                             \
             {look_from.x - ((point).x), look_from.y - (point).y},                                \
@@ -797,136 +3443,467 @@ i32 main(void) {
         };                                                                                       \
     } while (FALSE)
 
-        for (u32 i = 0; i < 4; ++i) {
-            LINE_BETWEEN(lines[i].translate);
-        }
-        for (u32 i = 1; i < len_quads; ++i) {
-            for (u32 j = 0; j < 4; ++j) {
-                LINE_BETWEEN(rotated_quads[i].points[j]);
-            }
-        }
-#undef LINE_BETWEEN
+        Vec2f*    points = NULL;
+        Triangle* triangles = NULL;
 
-        Vec2f points[CAP_POINTS];
+        u32* exported = NULL;
+        u32  len_exported = 0;
 
-        len_points = 0;
-        for (u32 i = 4; i < len_lines; ++i) {
-            assert((len_points + 2) < CAP_POINTS);
-            points[len_points++] = lines[i].translate;
-            points[len_points++] =
-                extend(look_from, turn(look_from, lines[i].translate, -EPSILON), WINDOW_DIAGONAL);
-            points[len_points++] =
-                extend(look_from, turn(look_from, lines[i].translate, EPSILON), WINDOW_DIAGONAL);
-        }
+        // NOTE: Static geoms only take part when the PVS of the viewer's cell says they might be
+        // seen, and then only with the edges it says might be. Geoms that spin, polygons, the
+        // player, and static geoms of touched chunks outside the PVS's reach are always tested in
+        // full. All but the player are copied out of `store`, culled for the viewer on the way.
+        Occluders occluders = occluders_alloc(&arena, cap_vertices, cap_vertices);
 
-        for (u32 i = 0; i < len_points; ++i) {
-            Vec2f a[2] = {look_from, points[i]};
-            for (u32 j = 1; j < len_quads; ++j) {
-                Vec2f b[2] = {
-                    rotated_quads[j].points[0],
-                    rotated_quads[j].points[1],
-                };
-                intersect(a, b, &points[i]);
+        if (occluders.vertices && occluders.edges && occluders.table) {
+            const u32 col = (u32)clamp(look_from.x / CHUNK_WIDTH, 0.0f, CHUNK_COLS - 1);
+            const u32 row = (u32)clamp(look_from.y / CHUNK_HEIGHT, 0.0f, CHUNK_ROWS - 1);
 
-                a[1] = points[i];
-                b[0] = rotated_quads[j].points[2];
-                intersect(a, b, &points[i]);
+            const Chunk* viewer = NULL;
+            for (u32 i = 0; i < CAP_CHUNKS; ++i) {
+                if (chunks[i].loaded && (chunks[i].col == col) && (chunks[i].row == row)) {
+                    viewer = &chunks[i];
+                }
+            }
 
-                a[1] = points[i];
-                b[1] = rotated_quads[j].points[3];
-                intersect(a, b, &points[i]);
+            const Chunk* neighbors[PVS_SPAN * PVS_SPAN] = {0};
+            for (u32 i = 0; i < CAP_CHUNKS; ++i) {
+                if (!chunks[i].touched) {
+                    continue;
+                }
+                const i32 dx = (i32)chunks[i].col - (i32)col + PVS_RADIUS;
+                const i32 dy = (i32)chunks[i].row - (i32)row + PVS_RADIUS;
+                Bool      reach = FALSE;
+                if (viewer && (0 <= dx) && (dx < PVS_SPAN) && (0 <= dy) && (dy < PVS_SPAN)) {
+                    reach = TRUE;
+                    neighbors[((u32)dy * PVS_SPAN) + (u32)dx] = &chunks[i];
+                }
+                for (u32 j = 0; j < chunks[i].len_geoms; ++j) {
+                    if (chunks[i].spin[j] || (!reach)) {
+                        occluders_copy(&occluders,
+                                       &store.occluders,
+                                       store.firsts[i][j],
+                                       store.lens[i][j],
+                                       0xF,
+                                       look_from);
+                    }
+                }
+                for (u32 j = 0; j < chunks[i].len_polygons; ++j) {
+                    occluders_copy(&occluders,
+                                   &store.occluders,
+                                   store.firsts[i][CAP_CHUNK_GEOMS + j],
+                                   store.lens[i][CAP_CHUNK_GEOMS + j],
+                                   UINT32_MAX,
+                                   look_from);
+                }
+            }
 
-                a[1] = points[i];
-                b[0] = rotated_quads[j].points[0];
-                intersect(a, b, &points[i]);
+            if (viewer) {
+                const f32 x = ((look_from.x / CHUNK_WIDTH) - (f32)col) * PVS_CELL_COLS;
+                const f32 y = ((look_from.y / CHUNK_HEIGHT) - (f32)row) * PVS_CELL_ROWS;
+                const u32 cell = ((u32)clamp(y, 0.0f, PVS_CELL_ROWS - 1) * PVS_CELL_COLS) +
+                                 (u32)clamp(x, 0.0f, PVS_CELL_COLS - 1);
+                for (u32 i = 0; i < viewer->len_pvs[cell]; ++i) {
+                    const u16    entry = viewer->pvs[cell][i];
+                    const Chunk* chunk =
+                        neighbors[((u32)(entry >> 9) * PVS_SPAN) + ((u32)(entry >> 6) & 7)];
+                    if (!chunk) {
+                        continue;
+                    }
+                    const u32 slot = (u32)(chunk - chunks);
+                    occluders_copy(&occluders,
+                                   &store.occluders,
+                                   store.firsts[slot][(entry >> 4) & 3],
+                                   store.lens[slot][(entry >> 4) & 3],
+                                   (u32)entry & 0xF,
+                                   look_from);
+                }
             }
-            for (u32 j = 0; j < 4; ++j) {
-                a[1] = points[i];
-                const Vec2f b[2] = {
-                    lines[j].translate,
-                    {
-                        lines[j].translate.x + lines[j].scale.x,
-                        lines[j].translate.y + lines[j].scale.y,
-                    },
-                };
-                intersect(a, b, &points[i]);
+
+            if (rotated_quads) {
+                occluders_push(&occluders,
+                               &look_from,
+                               rotated_quads[len_quads - 1].points,
+                               4,
+                               0xF,
+                               ID_PLAYER);
             }
         }
 
-        for (u32 i = 1; i < len_points; ++i) {
-            for (u32 j = i; 0 < j; --j) {
-                f32 angle =
-                    polar_degrees((Vec2f){points[j].x - look_from.x, points[j].y - look_from.y}) -
-                    polar_degrees(
-                        (Vec2f){points[j - 1].x - look_from.x, points[j - 1].y - look_from.y});
-                if (angle < -180.0f) {
-                    angle += 360.0f;
-                }
-                if (180.0f < angle) {
-                    angle -= 360.0f;
+        len_edges = occluders.len_edges;
+        len_vertices = occluders.len_vertices;
+
+        if ((!events.shadow_map) && rotated_quads && lines && occluders.vertices &&
+            occluders.edges && occluders.table)
+        {
+            for (u32 i = 0; i < 4; ++i) {
+                LINE_BETWEEN(border[i].translate);
+            }
+            for (u32 i = 0; i < occluders.len_vertices; ++i) {
+                LINE_BETWEEN(occluders.vertices[i]);
+            }
+#undef LINE_BETWEEN
+
+            points = arena_alloc(&arena, sizeof(Vec2f) * (len_lines - 4) * 3);
+
+            len_points = 0;
+            for (u32 i = 4; points && (i < len_lines); ++i) {
+                points[len_points++] = lines[i].translate;
+                points[len_points++] = extend(look_from,
+                                              turn(look_from, lines[i].translate, -EPSILON),
+                                              WINDOW_DIAGONAL);
+                points[len_points++] = extend(look_from,
+                                              turn(look_from, lines[i].translate, EPSILON),
+                                              WINDOW_DIAGONAL);
+            }
+
+            len_threads = pool_cast(&pool,
+                                    (Rays){
+                                        .origin = look_from,
+                                        .occluders = &occluders,
+                                        .border = &border[0],
+                                        .points = points,
+                                        .len_points = len_points,
+                                    });
+
+            for (u32 i = 1; i < len_points; ++i) {
+                for (u32 j = i; 0 < j; --j) {
+                    f32 angle = polar_degrees((Vec2f){
+                                    points[j].x - look_from.x,
+                                    points[j].y - look_from.y,
+                                }) -
+                                polar_degrees((Vec2f){
+                                    points[j - 1].x - look_from.x,
+                                    points[j - 1].y - look_from.y,
+                                });
+                    if (angle < -180.0f) {
+                        angle += 360.0f;
+                    }
+                    if (180.0f < angle) {
+                        angle -= 360.0f;
+                    }
+
+                    if (angle < 0.0f) {
+                        break;
+                    }
+                    const Vec2f point = points[j - 1];
+                    points[j - 1] = points[j];
+                    points[j] = point;
                 }
+            }
 
-                if (angle < 0.0f) {
-                    break;
+            len_visible = 0;
+            {
+                const u32 len_queries = (len_quads - 2) * 4;
+                Vec2f*    queries = arena_alloc(&arena, sizeof(Vec2f) * len_queries);
+                Bool*     visible = arena_alloc(&arena, sizeof(Bool) * len_queries);
+                exported = arena_alloc(&arena, sizeof(u32) * (len_quads - 2));
+                if (queries && visible && exported) {
+                    for (u32 i = 1; i < (len_quads - 1); ++i) {
+                        for (u32 j = 0; j < 4; ++j) {
+                            queries[((i - 1) * 4) + j] = rotated_quads[i].points[j];
+                        }
+                    }
+                    query_visible(look_from, points, len_points, queries, visible, len_queries);
+
+                    for (u32 i = 0; i < len_queries; ++i) {
+                        if (visible[i]) {
+                            ++len_visible;
+                        }
+                    }
+                    for (u32 i = 1; i < (len_quads - 1); ++i) {
+                        const Bool* corners = &visible[(i - 1) * 4];
+                        if (corners[0] || corners[1] || corners[2] || corners[3]) {
+                            exported[len_exported++] = ids[i];
+                        }
+                    }
                 }
-                const Vec2f point = points[j - 1];
-                points[j - 1] = points[j];
-                points[j] = point;
-            }
-        }
-
-        len_triangles = 0;
-        for (u32 i = 1; i < len_points; ++i) {
-            assert(len_triangles < CAP_TRIANGLES);
-            triangles[len_triangles++] = (Triangle){{
-                {look_from, COLOR_TRIANGLE_0},
-                {points[i - 1], COLOR_TRIANGLE_1},
-                {points[i], COLOR_TRIANGLE_2},
-            }};
-        }
-        for (u32 i = 0; i < len_triangles; ++i) {
-            for (u32 j = 1; j < 3; ++j) {
-                const f32 x =
-                    triangles[i].points[j].translate.x - triangles[i].points[0].translate.x;
-                const f32 y =
-                    triangles[i].points[j].translate.y - triangles[i].points[0].translate.y;
-                f32 t = sqrtf((x * x) + (y * y)) / WINDOW_DIAGONAL;
-                if (1.0f < t) {
-                    t = 1.0f;
-                } else if (t < 0.0f) {
-                    t = 0.0f;
+            }
+
+            triangles = arena_alloc(&arena, sizeof(Triangle) * len_points);
+
+            len_triangles = 0;
+            for (u32 i = 1; triangles && (i < len_points); ++i) {
+                triangles[len_triangles++] = (Triangle){{
+                    {look_from, COLOR_TRIANGLE_0},
+                    {points[i - 1], COLOR_TRIANGLE_1},
+                    {points[i], COLOR_TRIANGLE_2},
+                }};
+            }
+            for (u32 i = 0; i < len_triangles; ++i) {
+                for (u32 j = 1; j < 3; ++j) {
+                    const f32 x =
+                        triangles[i].points[j].translate.x - triangles[i].points[0].translate.x;
+                    const f32 y =
+                        triangles[i].points[j].translate.y - triangles[i].points[0].translate.y;
+                    f32 t = sqrtf((x * x) + (y * y)) / WINDOW_DIAGONAL;
+                    if (1.0f < t) {
+                        t = 1.0f;
+                    } else if (t < 0.0f) {
+                        t = 0.0f;
+                    }
+                    const f32 alpha = 1.0f + -t;
+                    triangles[i].points[j].color.w = alpha;
                 }
-                const f32 alpha = 1.0f + -t;
-                triangles[i].points[j].color.w = alpha;
             }
+        } else {
+            len_points = 0;
+            len_triangles = 0;
+            len_visible = 0;
+            len_threads = 0;
         }
 
-        glBindFramebuffer(GL_FRAMEBUFFER, fbo[0]);
-        glClear(GL_COLOR_BUFFER_BIT);
+        // NOTE: A fan too large for the ring is published empty, same as for shadow-map frames.
+        ring_publish(ring,
+                     look_from,
+                     look_to,
+                     points,
+                     (len_points <= CAP_RING_POINTS) ? len_points : 0,
+                     exported,
+                     len_exported);
+
+        governor_begin(&governor);
+        glViewport(0, 0, render_width, render_height);
 
         glUseProgram(program_quad);
+        glUniformMatrix4fv(uniform_quad_view, 1, FALSE, &view.column_row[0][0]);
         glBindVertexArray(vao[1]);
         glBindBuffer(GL_ARRAY_BUFFER, instance_vbo[1]);
-        glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(quads[0]) * len_quads, &quads[0]);
-        glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, (i32)len_quads);
+        glBufferSubData(GL_ARRAY_BUFFER,
+                        0,
+                        sizeof(quads[0]) * (len_quads + len_markers),
+                        &quads[0]);
+
+        // NOTE: The static part of the scene lives in `fbo[2]`, drawn in the world around where the
+        // camera was at the time, `LAYER_MARGIN` pixels past the window on every side. Each frame
+        // copies over the part the window now covers; it only gets redrawn once the camera has
+        // moved past the margin or chunks under it were (un)loaded. Both targets share their
+        // sample count, so the blit copies samples one-to-one.
+        {
+            const Vec2f margin = {
+                LAYER_MARGIN / render_scale.x,
+                LAYER_MARGIN / render_scale.y,
+            };
+            // NOTE: Padded by a pixel, since the camera is off the snapped view by up to half one.
+            const Vec2f extent = {
+                (screen.x / 2.0f) + margin.x + 1.0f,
+                (screen.y / 2.0f) + margin.y + 1.0f,
+            };
+            const i32 offset_x = cached_x - translate_x;
+            const i32 offset_y = cached_y - translate_y;
+            if ((!cached) || (offset_x < -LAYER_MARGIN) || (LAYER_MARGIN < offset_x) ||
+                (offset_y < -LAYER_MARGIN) || (LAYER_MARGIN < offset_y) ||
+                (cached_signature !=
+                 layer_chunks(chunks, cached_center, extent, NULL, NULL, NULL, NULL)))
+            {
+                u32 len_layer = 0;
+                u32 len_layer_triangles = 0;
+                layer_chunks(chunks, camera, extent, NULL, NULL, NULL, &len_layer_triangles);
+                Triangle* layer_triangles =
+                    arena_alloc(&arena, sizeof(Triangle) * len_layer_triangles);
+                len_layer_triangles = 0;
+                layer[len_layer++] = quads[0];
+                cached_signature = layer_chunks(chunks,
+                                                camera,
+                                                extent,
+                                                layer,
+                                                &len_layer,
+                                                layer_triangles,
+                                                &len_layer_triangles);
+                cached_center = camera;
+                cached_x = translate_x;
+                cached_y = translate_y;
+                // NOTE: Without room for the polygons, the layer gets drawn again next frame.
+                cached = layer_triangles ? TRUE : FALSE;
+
+                const Mat4 layer_projection = orthographic(0,
+                                                           screen.x + (margin.x * 2.0f),
+                                                           screen.y + (margin.y * 2.0f),
+                                                           0,
+                                                           VIEW_NEAR,
+                                                           VIEW_FAR);
+                const Mat4 layer_view = translate_rotate(
+                    (Vec2f){view_translate.x + margin.x, view_translate.y + margin.y},
+                    VIEW_ROTATE_RADIANS);
+                glUniformMatrix4fv(uniform_quad_projection,
+                                   1,
+                                   FALSE,
+                                   &layer_projection.column_row[0][0]);
+                glUniformMatrix4fv(uniform_quad_view, 1, FALSE, &layer_view.column_row[0][0]);
+                glBindBuffer(GL_ARRAY_BUFFER, instance_vbo[2]);
+                glBufferData(GL_ARRAY_BUFFER, sizeof(Geom) * len_layer, layer, GL_DYNAMIC_DRAW);
+                geom_instances(program_quad, 0);
+
+                glBindFramebuffer(GL_FRAMEBUFFER, fbo[2]);
+                glViewport(0,
+                           0,
+                           render_width + (LAYER_MARGIN * 2),
+                           render_height + (LAYER_MARGIN * 2));
+                glClear(GL_COLOR_BUFFER_BIT);
+                glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, (i32)len_layer);
+
+                glUseProgram(program_triangles);
+                glUniformMatrix4fv(uniform_triangles_projection,
+                                   1,
+                                   FALSE,
+                                   &layer_projection.column_row[0][0]);
+                glUniformMatrix4fv(uniform_triangles_view,
+                                   1,
+                                   FALSE,
+                                   &layer_view.column_row[0][0]);
+                glBindVertexArray(vao[6]);
+                glBindBuffer(GL_ARRAY_BUFFER, vbo[5]);
+                glBufferData(GL_ARRAY_BUFFER,
+                             sizeof(Triangle) * len_layer_triangles,
+                             layer_triangles,
+                             GL_DYNAMIC_DRAW);
+                glDrawArrays(GL_TRIANGLES, 0, (i32)(len_layer_triangles * 3));
+                glUniformMatrix4fv(uniform_triangles_projection,
+                                   1,
+                                   FALSE,
+                                   &projection.column_row[0][0]);
+
+                glViewport(0, 0, render_width, render_height);
+                glUseProgram(program_quad);
+                glUniformMatrix4fv(uniform_quad_projection,
+                                   1,
+                                   FALSE,
+                                   &projection.column_row[0][0]);
+                glUniformMatrix4fv(uniform_quad_view, 1, FALSE, &view.column_row[0][0]);
+                glBindVertexArray(vao[1]);
+                glBindBuffer(GL_ARRAY_BUFFER, instance_vbo[1]);
+                ++len_redraws;
+            }
 
-        glBindFramebuffer(GL_FRAMEBUFFER, fbo[1]);
-        glClear(GL_COLOR_BUFFER_BIT);
+            // NOTE: Framebuffer rows count up from the bottom, where the view's rows count down.
+            const i32 x = LAYER_MARGIN + (cached_x - translate_x);
+            const i32 y = LAYER_MARGIN - (cached_y - translate_y);
+            glBindFramebuffer(GL_READ_FRAMEBUFFER, fbo[2]);
+            glBindFramebuffer(GL_DRAW_FRAMEBUFFER, fbo[0]);
+            glBlitFramebuffer(x,
+                              y,
+                              x + render_width,
+                              y + render_height,
+                              0,
+                              0,
+                              render_width,
+                              render_height,
+                              GL_COLOR_BUFFER_BIT,
+                              GL_NEAREST);
+        }
+
+        glBindFramebuffer(GL_FRAMEBUFFER, fbo[0]);
+        geom_instances(program_quad, len_static);
+        glDrawArraysInstanced(GL_TRIANGLE_STRIP,
+                              0,
+                              4,
+                              (i32)((len_quads + len_markers) - len_static));
+
+        if (events.shadow_map) {
+            u32 len_viewers = 0;
+            viewers[len_viewers++] = viewer_player;
+            // NOTE: Only occluders in view get drawn into the polar map, so a pinned view from
+            // outside of the camera's rect would see straight through whatever is off screen.
+            for (u32 i = 0; (i < pins) && (i < (CAP_VIEWERS - 1)); ++i) {
+                if ((fabsf(pinned[i].x - camera.x) <= (screen.x / 2.0f)) &&
+                    (fabsf(pinned[i].y - camera.y) <= (screen.y / 2.0f)))
+                {
+                    viewers[len_viewers++] = pinned[i];
+                }
+            }
+            assert(len_viewers <= CAP_VIEWERS);
+
+            glBindFramebuffer(GL_FRAMEBUFFER, polar_fbo);
+            glViewport(0, 0, POLAR_BINS, CAP_VIEWERS);
+            glDisable(GL_BLEND);
+            glEnable(GL_DEPTH_TEST);
+            glClear(GL_DEPTH_BUFFER_BIT);
+
+            // NOTE: Every edge of every occluder in view, skipping `quads[0]`, the world itself.
+            Vec4f* edges = arena_alloc(&arena, sizeof(Vec4f) * cap_vertices);
+            u32    len_edges_polar = 0;
+            for (u32 i = 1; rotated_quads && edges && (i < len_quads); ++i) {
+                for (u32 j = 0; j < 4; ++j) {
+                    const Vec2f a = rotated_quads[i].points[j];
+                    const Vec2f b = rotated_quads[i].points[(j + 1) % 4];
+                    edges[len_edges_polar++] = (Vec4f){a.x, a.y, b.x, b.y};
+                }
+            }
+            for (u32 i = 0; rotated_quads && edges && (i < CAP_CHUNKS); ++i) {
+                for (u32 j = 0; chunks[i].touched && (j < chunks[i].len_polygons); ++j) {
+                    const Polygon* polygon = &chunks[i].polygons[j];
+                    for (u32 k = 0; k < polygon->len_points; ++k) {
+                        const Vec2f a = polygon->points[k];
+                        const Vec2f b = polygon->points[(k + 1) % polygon->len_points];
+                        edges[len_edges_polar++] = (Vec4f){a.x, a.y, b.x, b.y};
+                    }
+                }
+            }
+
+            glUseProgram(program_polar);
+            glUniform4fv(uniform_polar_viewers, (i32)len_viewers, &viewers[0].x);
+            glBindVertexArray(vao[4]);
+            glBindBuffer(GL_ARRAY_BUFFER, instance_vbo[3]);
+            glBufferData(GL_ARRAY_BUFFER,
+                         sizeof(Vec4f) * len_edges_polar,
+                         edges,
+                         GL_DYNAMIC_DRAW);
+            glDrawArraysInstanced(GL_TRIANGLES,
+                                  0,
+                                  (i32)(POLAR_VERTICES * len_viewers),
+                                  (i32)len_edges_polar);
+
+            glDisable(GL_DEPTH_TEST);
+            glEnable(GL_BLEND);
+            glViewport(0, 0, render_width, render_height);
+
+            glBindFramebuffer(GL_FRAMEBUFFER, fbo[1]);
+            glClear(GL_COLOR_BUFFER_BIT);
+
+            const Vec2f mask[4] = {
+                {camera.x + (screen.x / 2.0f), camera.y + (screen.y / 2.0f)},
+                {camera.x + (screen.x / 2.0f), camera.y - (screen.y / 2.0f)},
+                {camera.x - (screen.x / 2.0f), camera.y + (screen.y / 2.0f)},
+                {camera.x - (screen.x / 2.0f), camera.y - (screen.y / 2.0f)},
+            };
 
-        glUseProgram(program_triangles);
-        glBindVertexArray(vao[2]);
-        glBindBuffer(GL_ARRAY_BUFFER, vbo[2]);
-        glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(triangles), &triangles[0]);
-        glDrawArrays(GL_TRIANGLES, 0, (i32)(len_triangles * 3));
+            glUseProgram(program_mask);
+            glUniformMatrix4fv(uniform_mask_view, 1, FALSE, &view.column_row[0][0]);
+            glUniform4fv(uniform_mask_viewers, (i32)len_viewers, &viewers[0].x);
+            glUniform1i(uniform_mask_len_viewers, (i32)len_viewers);
+            glBindVertexArray(vao[5]);
+            glBindBuffer(GL_ARRAY_BUFFER, vbo[4]);
+            glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(mask), &mask[0]);
+            glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+        } else {
+            glBindFramebuffer(GL_FRAMEBUFFER, fbo[1]);
+            glClear(GL_COLOR_BUFFER_BIT);
+
+            glUseProgram(program_triangles);
+            glUniformMatrix4fv(uniform_triangles_view, 1, FALSE, &view.column_row[0][0]);
+            glBindVertexArray(vao[2]);
+            glBindBuffer(GL_ARRAY_BUFFER, vbo[2]);
+            // NOTE: The fan grows with however much is in view, so its buffer gets respecified.
+            glBufferData(GL_ARRAY_BUFFER,
+                         sizeof(Triangle) * len_triangles,
+                         triangles,
+                         GL_DYNAMIC_DRAW);
+            glDrawArrays(GL_TRIANGLES, 0, (i32)(len_triangles * 3));
+        }
 
         glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        glViewport(0, 0, width, height);
         glClear(GL_COLOR_BUFFER_BIT);
 
 #if 0
         glUseProgram(program_line);
+        glUniformMatrix4fv(glGetUniformLocation(program_line, "VIEW"),
+                           1,
+                           FALSE,
+                           &view.column_row[0][0]);
         glBindVertexArray(vao[0]);
         glBindBuffer(GL_ARRAY_BUFFER, instance_vbo[0]);
-        glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(lines), &lines[0]);
+        glBufferData(GL_ARRAY_BUFFER, sizeof(Geom) * len_lines, lines, GL_DYNAMIC_DRAW);
         glDrawArraysInstanced(GL_LINES, 0, 2, (i32)len_lines);
 #endif
 
@@ -936,9 +3913,22 @@ i32 main(void) {
         glDrawArrays(GL_TRIANGLE_STRIP, 0, LEN_SHADOWS);
 #undef LEN_SHADOWS
 
+        governor_end(&governor);
+        const u64 cpu = now() - begun;
+
         glfwSwapBuffers(window);
+
+        present_push(&present, sampled);
+        present_retire(&present, low_latency);
+
+        governor_update(&governor, nanos_per_frame, cpu);
     }
 
+    present_retire(&present, TRUE);
+
+    glDeleteTextures(1, &polar_texture);
+    glDeleteFramebuffers(1, &polar_fbo);
+    glDeleteQueries(CAP_TIMERS, &governor.timers[0]);
     glDeleteTextures(CAP_TEXTURES, &textures[0]);
     glDeleteFramebuffers(CAP_FBO, &fbo[0]);
     glDeleteBuffers(CAP_INSTANCE_VBO, &instance_vbo[0]);
@@ -949,6 +3939,15 @@ i32 main(void) {
     glDeleteProgram(program_quad);
     glDeleteProgram(program_triangles);
     glDeleteProgram(program_shadow);
+    glDeleteProgram(program_polar);
+    glDeleteProgram(program_mask);
+
+    assert(munmap(arena.buffer, arena.cap) == 0);
+    assert(munmap(ring, sizeof(Ring)) == 0);
+
+    store_close(&store);
+    pool_stop(&pool, workers);
+    loader_stop(&loader);
 
     glfwDestroyWindow(window);
     glfwTerminate();
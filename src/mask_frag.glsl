@@ -0,0 +1,40 @@
+#version 330 core
+
+layout(location = 0) out vec4 FRAG_OUT_COLOR;
+
+in vec2 VERT_OUT_POSITION;
+
+uniform sampler2D POLAR;
+
+// NOTE: Must match `CAP_VIEWERS` in `main.c`. Each viewer is `(x, y, look radians, half fov)`.
+uniform vec4 VIEWERS[16];
+uniform int  LEN_VIEWERS;
+
+uniform float DISTANCE;
+uniform vec4  COLOR;
+
+#define PI  3.14159265358979f
+#define TAU (PI * 2.0f)
+
+void main() {
+    int   bins = textureSize(POLAR, 0).x;
+    float alpha = 0.0f;
+    for (int i = 0; i < LEN_VIEWERS; ++i) {
+        vec2  ray = VERT_OUT_POSITION - VIEWERS[i].xy;
+        float radians = atan(ray.y, ray.x);
+
+        float look = radians - VIEWERS[i].z;
+        look -= TAU * floor((look + PI) / TAU);
+        if (VIEWERS[i].w < abs(look)) {
+            continue;
+        }
+
+        int   bin = int(((radians < 0.0f ? radians + TAU : radians) / TAU) * float(bins)) % bins;
+        float distance = length(ray);
+        if ((texelFetch(POLAR, ivec2(bin, i), 0).r * DISTANCE) < distance) {
+            continue;
+        }
+        alpha = max(alpha, 1.0f - min(distance / DISTANCE, 1.0f));
+    }
+    FRAG_OUT_COLOR = vec4(COLOR.rgb, COLOR.a * alpha);
+}
@@ -0,0 +1,13 @@
+#version 330 core
+
+layout(location = 0) in vec2 VERT_IN_POSITION;
+
+uniform mat4 PROJECTION;
+uniform mat4 VIEW;
+
+out vec2 VERT_OUT_POSITION;
+
+void main() {
+    gl_Position = PROJECTION * VIEW * vec4(VERT_IN_POSITION, 0.0f, 1.0f);
+    VERT_OUT_POSITION = VERT_IN_POSITION;
+}
@@ -0,0 +1,31 @@
+#version 330 core
+
+flat in vec2 VERT_OUT_VIEWER;
+flat in vec4 VERT_OUT_EDGE;
+
+uniform int   BINS;
+uniform float DISTANCE;
+
+#define PI  3.14159265358979f
+#define TAU (PI * 2.0f)
+
+float cross2(vec2 a, vec2 b) {
+    return (a.x * b.y) - (a.y * b.x);
+}
+
+// NOTE: Depth is the distance along this bin's center ray to the edge, normalized by `DISTANCE`;
+// depth testing keeps the nearest edge per bin. Rays that miss (only possible in the padding bins)
+// clamp to the nearest endpoint.
+void main() {
+    float radians = (gl_FragCoord.x / float(BINS)) * TAU;
+    vec2  ray = vec2(cos(radians), sin(radians));
+
+    vec2 a = VERT_OUT_EDGE.xy - VERT_OUT_VIEWER;
+    vec2 b = VERT_OUT_EDGE.zw - VERT_OUT_VIEWER;
+    vec2 edge = b - a;
+
+    float denominator = cross2(ray, edge);
+    float t = denominator == 0.0f ? 0.0f : clamp(-cross2(ray, a) / denominator, 0.0f, 1.0f);
+
+    gl_FragDepth = clamp(length(a + (edge * t)) / DISTANCE, 0.0f, 1.0f);
+}
@@ -0,0 +1,62 @@
+#version 330 core
+
+layout(location = 1) in vec4 VERT_IN_EDGE;
+
+// NOTE: Must match `CAP_VIEWERS` in `main.c`.
+uniform vec4 VIEWERS[16];
+uniform int  ROWS;
+uniform int  BINS;
+
+flat out vec2 VERT_OUT_VIEWER;
+flat out vec4 VERT_OUT_EDGE;
+
+#define PI  3.14159265358979f
+#define TAU (PI * 2.0f)
+
+const vec2 CORNERS[6] = vec2[6](vec2(0.0f),
+                                vec2(1.0f, 0.0f),
+                                vec2(0.0f, 1.0f),
+                                vec2(0.0f, 1.0f),
+                                vec2(1.0f, 0.0f),
+                                vec2(1.0f));
+
+float polar_radians(vec2 point) {
+    float radians = atan(point.y, point.x);
+    return radians < 0.0f ? radians + TAU : radians;
+}
+
+// NOTE: Every instance is one occluder edge, every viewer gets `12` vertices: a pair of quads
+// spanning the angular range the edge covers as seen from the viewer, on the viewer's row of the
+// polar map. The second quad of the pair is only needed when the edge straddles angle zero.
+void main() {
+    int  viewer = gl_VertexID / 12;
+    int  piece = (gl_VertexID / 6) % 2;
+    vec2 uv = CORNERS[gl_VertexID % 6];
+
+    vec2 a = VERT_IN_EDGE.xy;
+    vec2 b = VERT_IN_EDGE.zw;
+
+    float radians_a = polar_radians(a - VIEWERS[viewer].xy);
+    float radians_b = polar_radians(b - VIEWERS[viewer].xy);
+
+    float low = min(radians_a, radians_b);
+    float high = max(radians_a, radians_b);
+
+    // NOTE: Pad by a bin on either side so bins only partially covered by the edge still get
+    // rasterized; the fragment shader clamps to the edge's endpoints.
+    float pad = TAU / float(BINS);
+    vec2  span = vec2(low - pad, high + pad);
+    if (PI < (high - low)) {
+        span = piece == 0 ? vec2(high - pad, TAU + pad) : vec2(-pad, low + pad);
+    } else if (piece == 1) {
+        span = vec2(low);
+    }
+    span = ((span / TAU) * 2.0f) - 1.0f;
+
+    gl_Position = vec4(mix(span.x, span.y, uv.x),
+                       (((float(viewer) + uv.y) / float(ROWS)) * 2.0f) - 1.0f,
+                       0.0f,
+                       1.0f);
+    VERT_OUT_VIEWER = VIEWERS[viewer].xy;
+    VERT_OUT_EDGE = vec4(a, b);
+}
@@ -0,0 +1,167 @@
+#include <assert.h>
+#include <fcntl.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <sys/mman.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "ring.h"
+
+typedef uint32_t u32;
+typedef uint64_t u64;
+typedef int32_t  i32;
+typedef float    f32;
+typedef double   f64;
+
+typedef struct timespec Time;
+
+#define NANOS_PER_SECOND 1000000000
+
+// NOTE: How long to back off for when no new frame has been published yet. This bounds how much
+// of the measured latency is just the reader polling.
+#define POLL_NANOS 20000
+
+static u64 now(void) {
+    Time time;
+    assert(clock_gettime(CLOCK_MONOTONIC, &time) == 0);
+    return ((u64)time.tv_sec * NANOS_PER_SECOND) + (u64)time.tv_nsec;
+}
+
+static f32 fan_area(RingPoint origin, const RingPoint* points, u32 len_points) {
+    f32 area = 0.0f;
+    for (u32 i = 1; i < len_points; ++i) {
+        const f32 x0 = points[i - 1].x - origin.x;
+        const f32 y0 = points[i - 1].y - origin.y;
+        const f32 x1 = points[i].x - origin.x;
+        const f32 y1 = points[i].y - origin.y;
+        const f32 cross = (x0 * y1) - (y0 * x1);
+        area += cross < 0.0f ? -cross : cross;
+    }
+    return area / 2.0f;
+}
+
+// NOTE: Follows the engine's ring from a separate process and reports, once a second, how many
+// frames made it across, how stale they were by the time they were read, and how many were lost to
+// falling behind or to the producer overwriting a slot mid-read. Slots are read in place; nothing
+// but the few numbers being reported is copied out.
+i32 main(void) {
+    i32 file = shm_open(RING_NAME, O_RDONLY, 0);
+    while (file < 0) {
+        fprintf(stderr, "Waiting for `%s`...\n", RING_NAME);
+        sleep(1);
+        file = shm_open(RING_NAME, O_RDONLY, 0);
+    }
+
+    const Ring* ring = mmap(NULL, sizeof(Ring), PROT_READ, MAP_SHARED, file, 0);
+    close(file);
+    assert(ring != MAP_FAILED);
+
+    while (__atomic_load_n(&ring->magic, __ATOMIC_ACQUIRE) != RING_MAGIC) {
+        sleep(1);
+    }
+    assert(ring->version == RING_VERSION);
+    assert(ring->cap_slots == CAP_RING_SLOTS);
+    assert(ring->size_slot == sizeof(RingSlot));
+
+    u64 last = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+
+    u64 prev = now();
+    u64 frames = 0;
+    u64 bytes = 0;
+    u64 dropped = 0;
+    u64 torn = 0;
+    u64 latency_min = UINT64_MAX;
+    u64 latency_max = 0;
+    u64 latency_sum = 0;
+    f64 area_sum = 0.0;
+    u64 visible_sum = 0;
+
+    printf("\n\n\n\n\n\n\n");
+    for (;;) {
+        {
+            const u64 next = now();
+            if (NANOS_PER_SECOND <= (next - prev)) {
+                const f64 seconds = ((f64)(next - prev)) / NANOS_PER_SECOND;
+                const f64 denominator = frames == 0 ? 1.0 : (f64)frames;
+                printf("\033[7A"
+                       "%9.0f frames/s\n"
+                       "%9.3f MiB/s\n"
+                       "%9lu dropped\n"
+                       "%9lu torn\n"
+                       "%9.1f us latency (min %.1f, max %.1f)\n"
+                       "%9.0f area\n"
+                       "%9.2f len_visible\n",
+                       ((f64)frames) / seconds,
+                       (((f64)bytes) / seconds) / (1024.0 * 1024.0),
+                       dropped,
+                       torn,
+                       (((f64)latency_sum) / denominator) / 1000.0,
+                       frames == 0 ? 0.0 : ((f64)latency_min) / 1000.0,
+                       ((f64)latency_max) / 1000.0,
+                       area_sum / denominator,
+                       ((f64)visible_sum) / denominator);
+                fflush(stdout);
+                prev = next;
+                frames = 0;
+                bytes = 0;
+                dropped = 0;
+                torn = 0;
+                latency_min = UINT64_MAX;
+                latency_max = 0;
+                latency_sum = 0;
+                area_sum = 0.0;
+                visible_sum = 0;
+            }
+        }
+
+        const u64 head = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+        if (head < last) {
+            // NOTE: The engine restarted and reset the ring.
+            last = 0;
+        }
+        if (head == last) {
+            const Time time = {0, POLL_NANOS};
+            nanosleep(&time, NULL);
+            continue;
+        }
+        if (CAP_RING_SLOTS < (head - last)) {
+            dropped += (head - last) - CAP_RING_SLOTS;
+            last = head - CAP_RING_SLOTS;
+        }
+
+        for (u64 frame = last + 1; frame <= head; ++frame) {
+            const RingSlot* slot = &ring->slots[(frame - 1) % CAP_RING_SLOTS];
+            const u64       sequence = __atomic_load_n(&slot->sequence, __ATOMIC_ACQUIRE);
+            if (sequence != (frame * 2)) {
+                ++dropped;
+                continue;
+            }
+
+            const u64 published = slot->published_nanos;
+            u32       len_points = slot->len_points;
+            u32       len_visible = slot->len_visible;
+            len_points = len_points < CAP_RING_POINTS ? len_points : CAP_RING_POINTS;
+            len_visible = len_visible < CAP_RING_VISIBLE ? len_visible : CAP_RING_VISIBLE;
+            const f32 area = fan_area(slot->origin, &slot->points[0], len_points);
+
+            __atomic_thread_fence(__ATOMIC_ACQUIRE);
+            if (__atomic_load_n(&slot->sequence, __ATOMIC_RELAXED) != sequence) {
+                ++torn;
+                continue;
+            }
+
+            const u64 read = now();
+            const u64 latency = published < read ? read - published : 0;
+            latency_min = latency < latency_min ? latency : latency_min;
+            latency_max = latency_max < latency ? latency : latency_max;
+            latency_sum += latency;
+            area_sum += (f64)area;
+            visible_sum += len_visible;
+            bytes += __builtin_offsetof(RingSlot, points) + (sizeof(RingPoint) * len_points) +
+                     (sizeof(u32) * len_visible);
+            ++frames;
+        }
+        last = head;
+    }
+}
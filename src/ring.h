@@ -0,0 +1,65 @@
+#ifndef RING_H
+#define RING_H
+
+#include <stdint.h>
+
+// NOTE: Fixed binary layout of the shared-memory ring the engine publishes every frame's
+// visibility into. There is a single producer (the engine) and any number of consumers, none of
+// which take locks or write to the ring. Each slot is guarded by its own sequence number:
+// - The producer first stores an odd value, then fills the slot in place, then stores
+//   `frame * 2`. Only after that does it bump `head` to `frame`.
+// - A consumer wanting frame `n` reads the slot at `(n - 1) % CAP_RING_SLOTS` in place.
+// - The read is valid only if the slot's sequence is `n * 2` both before and after.
+// Consumers that fall more than `CAP_RING_SLOTS` frames behind lose the frames in between.
+// Everything is little-endian, tightly packed, and fixed-size so other languages can map it as
+// well.
+
+#define RING_NAME    "/los"
+#define RING_MAGIC   0x534F4C52u
+#define RING_VERSION 3
+
+#define CAP_RING_SLOTS   (1 << 3)
+#define CAP_RING_POINTS  (1 << 10)
+#define CAP_RING_VISIBLE (1 << 8)
+
+_Static_assert((CAP_RING_SLOTS & (CAP_RING_SLOTS - 1)) == 0, "!(CAP_RING_SLOTS is a power of 2)");
+
+typedef struct {
+    float x, y;
+} RingPoint;
+
+// NOTE: `points` is the visibility fan around `origin`, sorted by descending angle. `visible`
+// holds the ids of every geom with at least one corner inside of it, where a geom's id is
+// `(((row * CHUNK_COLS) + col) * CAP_CHUNK_OCCLUDERS) + index`. Both are empty for frames drawn
+// with the GPU shadow map, and `points` is for frames whose fan does not fit.
+typedef struct {
+    uint64_t  sequence;
+    uint64_t  frame;
+    uint64_t  published_nanos;
+    RingPoint origin;
+    RingPoint look_to;
+    uint32_t  len_points;
+    uint32_t  len_visible;
+    RingPoint points[CAP_RING_POINTS];
+    uint32_t  visible[CAP_RING_VISIBLE];
+    uint8_t   pad[16];
+} RingSlot;
+
+typedef struct {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t cap_slots;
+    uint32_t size_slot;
+    uint64_t head;
+    uint8_t  pad[40];
+    RingSlot slots[CAP_RING_SLOTS];
+} Ring;
+
+// NOTE: Headers and slots each start on their own cache line, so a consumer polling `head` does
+// not share a line with the slot the producer is filling.
+_Static_assert(__builtin_offsetof(RingSlot, points) == 48, "!(RingSlot.points at 48)");
+_Static_assert((sizeof(RingSlot) % 64) == 0, "!(RingSlot is a multiple of 64 bytes)");
+_Static_assert(__builtin_offsetof(Ring, head) == 16, "!(Ring.head at 16)");
+_Static_assert(__builtin_offsetof(Ring, slots) == 64, "!(Ring.slots at 64)");
+
+#endif
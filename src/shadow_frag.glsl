@@ -10,6 +10,10 @@ uniform sampler2DMS MASK;
 uniform float BLEND;
 uniform int   MULTISAMPLES_SHADOW;
 
+// NOTE: Set whenever the textures are smaller than the window, in which case they get filtered
+// bilinearly instead of fetched one texel per pixel.
+uniform bool UPSCALE;
+
 // NOTE: See `https://stackoverflow.com/a/42882506`.
 vec4 texture_multisample(sampler2DMS sampler, ivec2 coord) {
     vec4 color = vec4(0.0);
@@ -20,10 +24,30 @@ vec4 texture_multisample(sampler2DMS sampler, ivec2 coord) {
     return color;
 }
 
+vec4 texture_bilinear(sampler2DMS sampler, vec2 position, ivec2 size) {
+    vec2  texel = (position * vec2(size)) - vec2(0.5f);
+    vec2  t = fract(texel);
+    ivec2 low = clamp(ivec2(floor(texel)), ivec2(0), size - ivec2(1));
+    ivec2 high = min(low + ivec2(1), size - ivec2(1));
+    vec4  top = mix(texture_multisample(sampler, low),
+                    texture_multisample(sampler, ivec2(high.x, low.y)),
+                    t.x);
+    vec4  bottom = mix(texture_multisample(sampler, ivec2(low.x, high.y)),
+                       texture_multisample(sampler, high),
+                       t.x);
+    return mix(top, bottom, t.y);
+}
+
 void main() {
     // NOTE: Since both textures *need* to be the same size, we can base the `position` off of
     // either of their `textureSize` values.
-    ivec2 position = ivec2(VERT_OUT_POSITION * textureSize(TEXTURE));
+    ivec2 size = textureSize(TEXTURE);
+    if (UPSCALE) {
+        FRAG_OUT_COLOR = vec4(texture_bilinear(TEXTURE, VERT_OUT_POSITION, size).rgb,
+                              mix(1.0f, texture_bilinear(MASK, VERT_OUT_POSITION, size).a, BLEND));
+        return;
+    }
+    ivec2 position = ivec2(VERT_OUT_POSITION * size);
     FRAG_OUT_COLOR = vec4(texture_multisample(TEXTURE, position).rgb,
                           mix(1.0f, texture_multisample(MASK, position).a, BLEND));
 }